@@ -0,0 +1,46 @@
+#include "BoardBenchmark.hpp"
+#include "../core/CounterRng.hpp"
+#include "../core/FixedGrid.hpp"
+#include "../core/Grid.hpp"
+#include <chrono>
+#include <vector>
+
+BoardBenchmark::BoardBenchmark(const BoardBenchmarkConfig& config)
+    : config(config) {
+}
+
+BoardBenchmarkResult BoardBenchmark::run() const {
+    // One counter-based word per grid word, as for a seeded soup in the window
+    Grid grid(WIDTH, HEIGHT);
+    const unsigned int wordsPerRow = grid.getWordsPerRow();
+    const uint32_t threshold = counterrng::densityThreshold(config.density);
+    std::vector<uint64_t> soup(static_cast<size_t>(wordsPerRow) * HEIGHT);
+    for (size_t i = 0; i < soup.size(); ++i) {
+        soup[i] = counterrng::bernoulliWord(config.seed, i, threshold);
+    }
+    grid.blit(soup.data(), wordsPerRow, WIDTH, HEIGHT, 0, 0, Grid::BlitMode::Copy);
+
+    // Both generations of the fixed grid live inline, about 2 KB on the stack
+    FixedGrid<WIDTH, HEIGHT> fixed(grid);
+
+    BoardBenchmarkResult result;
+    result.grid = stepAll(grid);
+    result.fixed = stepAll(fixed);
+    result.matched = result.grid.hash == result.fixed.hash &&
+                     grid.getGeneration() == fixed.getGeneration();
+    return result;
+}
+
+template <typename GridType>
+BoardBenchmarkRun BoardBenchmark::stepAll(GridType& grid) const {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t generation = 0; generation < config.generations; ++generation) {
+        grid.nextGeneration();
+    }
+
+    BoardBenchmarkRun run;
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.generationsPerSecond = run.seconds > 0.0 ? config.generations / run.seconds : 0.0;
+    run.hash = grid.getHash();
+    return run;
+}
@@ -0,0 +1,44 @@
+#ifndef BOARDBENCHMARK_HPP
+#define BOARDBENCHMARK_HPP
+
+#include <cstdint>
+
+struct BoardBenchmarkConfig {
+    uint64_t generations = 1000000;
+    uint64_t seed = 0;
+    float density = 0.35f;
+};
+
+struct BoardBenchmarkRun {
+    double seconds = 0.0;
+    double generationsPerSecond = 0.0;
+    uint64_t hash = 0;   // Grid::getHash() of the final generation
+};
+
+struct BoardBenchmarkResult {
+    BoardBenchmarkRun grid;    // Dynamic Grid, as the window steps it
+    BoardBenchmarkRun fixed;   // FixedGrid<WIDTH, HEIGHT>
+    bool matched = false;      // Both ended on the same cells
+};
+
+// Headless benchmark of the window's board: steps one seeded soup on a
+// WIDTH x HEIGHT universe as a Grid and as a FixedGrid of the same size,
+// and checks that both arrive at the same generation. The two share one
+// stepping loop, templated on the grid type.
+class BoardBenchmark {
+public:
+    static constexpr unsigned int WIDTH = 60;
+    static constexpr unsigned int HEIGHT = 40;
+
+    explicit BoardBenchmark(const BoardBenchmarkConfig& config = BoardBenchmarkConfig());
+
+    BoardBenchmarkResult run() const;
+
+private:
+    BoardBenchmarkConfig config;
+
+    template <typename GridType>
+    BoardBenchmarkRun stepAll(GridType& grid) const;
+};
+
+#endif // BOARDBENCHMARK_HPP
@@ -0,0 +1,328 @@
+#include "Census.hpp"
+#include "SoupSearch.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/Grid.hpp"
+#include "../patterns/PatternManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+// A horizontal run of live cells [x0, x1] in row y
+struct Run {
+    unsigned int y;
+    unsigned int x0;
+    unsigned int x1;
+};
+
+// Appends the runs of one packed row, following runs across word boundaries
+void appendRuns(const uint64_t* row, unsigned int wordsPerRow, unsigned int y, std::vector<Run>& runs) {
+    bool open = false;
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < wordsPerRow; ++i) {
+        const uint64_t word = row[i];
+        unsigned int pos = 0;
+        while (pos < 64) {
+            uint64_t above = ~bitops::lowMask(pos);
+            if (open) {
+                uint64_t zeros = ~word & above;
+                if (!zeros) break;
+                pos = bitops::countTrailingZeros(zeros);
+                runs.push_back({y, start, i * 64 + pos - 1});
+                open = false;
+            } else {
+                uint64_t ones = word & above;
+                if (!ones) break;
+                pos = bitops::countTrailingZeros(ones);
+                start = i * 64 + pos;
+                open = true;
+            }
+        }
+    }
+    if (open) {
+        runs.push_back({y, start, wordsPerRow * 64 - 1});
+    }
+}
+
+std::vector<std::pair<int, int>> collectCells(const Grid& grid) {
+    std::vector<std::pair<int, int>> cells;
+    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+        const uint64_t* row = grid.getRow(y);
+        for (unsigned int i = 0; i < grid.getWordsPerRow(); ++i) {
+            for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                cells.emplace_back(static_cast<int>(i * 64 + bitops::countTrailingZeros(bits)),
+                                   static_cast<int>(y));
+            }
+        }
+    }
+    return cells;
+}
+
+class UnionFind {
+public:
+    explicit UnionFind(size_t count) : parent(count) {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+
+    uint32_t find(uint32_t node) {
+        while (parent[node] != node) {
+            parent[node] = parent[parent[node]]; // Path halving
+            node = parent[node];
+        }
+        return node;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a < b) {
+            parent[b] = a;
+        } else if (b < a) {
+            parent[a] = b;
+        }
+    }
+
+private:
+    std::vector<uint32_t> parent;
+};
+
+} // namespace
+
+Census::Census(const PatternManager& patterns) {
+    for (const std::string& name : patterns.getPatternNames()) {
+        addObject(name, patterns.getPattern(name));
+    }
+}
+
+void Census::addObject(const std::string& name, const Pattern& pattern) {
+    if (pattern.width == 0 || pattern.height == 0) return;
+
+    // Step the pattern in isolation, with room to move a full period
+    const unsigned int pad = MAX_PERIOD / 2 + 2;
+    Grid grid(pattern.width + 2 * pad, pattern.height + 2 * pad);
+    grid.blit(pattern.rows.data(), pattern.wordsPerRow, pattern.width, pattern.height, pad, pad);
+
+    const auto initial = collectCells(grid);
+    if (initial.empty()) return;
+    std::vector<uint64_t> phases{canonicalHash(initial)};
+
+    bool periodic = false;
+    for (unsigned int generation = 1; generation <= MAX_PERIOD && !periodic; ++generation) {
+        grid.nextGeneration();
+        const auto cells = collectCells(grid);
+        bool touchesEdge = std::any_of(cells.begin(), cells.end(), [&grid](const std::pair<int, int>& cell) {
+            return cell.first == 0 || cell.second == 0 ||
+                   cell.first + 1 == static_cast<int>(grid.getWidth()) ||
+                   cell.second + 1 == static_cast<int>(grid.getHeight());
+        });
+        if (cells.empty() || touchesEdge) break;
+
+        uint64_t hash = canonicalHash(cells);
+        periodic = hash == phases.front();
+        if (!periodic) {
+            phases.push_back(hash);
+        }
+    }
+
+    // A pattern that never repeats (a methuselah, say) is only known by its start
+    if (!periodic) {
+        phases.resize(1);
+    }
+    for (uint64_t hash : phases) {
+        names.emplace(hash, name); // The first pattern to claim a shape keeps it
+    }
+}
+
+uint64_t Census::canonicalHash(const std::vector<std::pair<int, int>>& cells) {
+    if (cells.empty()) return 0;
+
+    int minX = cells.front().first;
+    int maxX = minX;
+    int minY = cells.front().second;
+    int maxY = minY;
+    for (const auto& cell : cells) {
+        minX = std::min(minX, cell.first);
+        maxX = std::max(maxX, cell.first);
+        minY = std::min(minY, cell.second);
+        maxY = std::max(maxY, cell.second);
+    }
+    const int width = maxX - minX + 1;
+    const int height = maxY - minY + 1;
+    uint64_t best = ~0ULL;
+
+    auto mix = [](uint64_t hash, uint64_t key) {
+        hash = (hash ^ key) * 0x100000001B3ULL;
+        return hash ^ (hash >> 29);
+    };
+
+    // Symmetry bits: 4 = transpose, 1 = mirror x, 2 = mirror y (after transposing)
+    if (width <= 64 && height <= 64) {
+        // Objects that fit a 64x64 box (nearly all of them) are drawn into a
+        // packed bitmap per orientation and hashed row by row, with no sorting
+        uint64_t rows[64];
+        for (int symmetry = 0; symmetry < 8; ++symmetry) {
+            const bool transpose = symmetry & 4;
+            const int outWidth = transpose ? height : width;
+            const int outHeight = transpose ? width : height;
+            std::fill_n(rows, outHeight, 0);
+            for (const auto& cell : cells) {
+                int x = cell.first - minX;
+                int y = cell.second - minY;
+                if (transpose) std::swap(x, y);
+                if (symmetry & 1) x = outWidth - 1 - x;
+                if (symmetry & 2) y = outHeight - 1 - y;
+                rows[y] |= 1ULL << x;
+            }
+
+            uint64_t hash = mix(0xCBF29CE484222325ULL, (static_cast<uint64_t>(outWidth) << 32) | outHeight);
+            for (int y = 0; y < outHeight; ++y) {
+                hash = mix(hash, rows[y]);
+            }
+            best = std::min(best, hash);
+        }
+        return best;
+    }
+
+    // Larger objects hash their sorted cell list instead
+    std::vector<std::pair<int, int>> transformed(cells.size());
+    for (int symmetry = 0; symmetry < 8; ++symmetry) {
+        const bool transpose = symmetry & 4;
+        const int outWidth = transpose ? height : width;
+        const int outHeight = transpose ? width : height;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            int x = cells[i].first - minX;
+            int y = cells[i].second - minY;
+            if (transpose) std::swap(x, y);
+            if (symmetry & 1) x = outWidth - 1 - x;
+            if (symmetry & 2) y = outHeight - 1 - y;
+            transformed[i] = {y, x}; // Row-major sort order
+        }
+        std::sort(transformed.begin(), transformed.end());
+
+        uint64_t hash = mix(0x84222325CBF29CE4ULL, cells.size());
+        for (const auto& cell : transformed) {
+            hash = mix(hash, (static_cast<uint64_t>(cell.first) << 32) | static_cast<uint32_t>(cell.second));
+        }
+        best = std::min(best, hash);
+    }
+    return best;
+}
+
+const std::string& Census::nameFor(uint64_t hash, const std::vector<std::pair<int, int>>& cells) {
+    auto it = names.find(hash);
+    if (it != names.end()) {
+        return it->second;
+    }
+
+    // The code ends in the object's shape, the same in every phase
+    ObjectClass object = SoupSearch::classifyObject(cells, MAX_PERIOD);
+    return names.emplace(hash, object.getCode()).first->second;
+}
+
+CensusResult Census::run(const Grid& grid) {
+    auto start = std::chrono::steady_clock::now();
+    CensusResult result;
+
+    std::vector<Run> runs;
+    std::vector<size_t> rowStart(grid.getHeight() + 1, 0);
+    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+        rowStart[y] = runs.size();
+        appendRuns(grid.getRow(y), grid.getWordsPerRow(), y, runs);
+    }
+    rowStart[grid.getHeight()] = runs.size();
+
+    // Join runs in the same row and in the rows up to CONNECT_DISTANCE above
+    // whose spans, widened by CONNECT_DISTANCE, overlap. Both rows are sorted
+    // by x, so one merge-like pass per row pair finds every overlap.
+    UnionFind components(runs.size());
+    const int reach = CONNECT_DISTANCE;
+    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+        for (size_t k = rowStart[y] + 1; k < rowStart[y + 1]; ++k) {
+            if (static_cast<int>(runs[k].x0 - runs[k - 1].x1) <= reach) {
+                components.unite(static_cast<uint32_t>(k - 1), static_cast<uint32_t>(k));
+            }
+        }
+
+        for (int d = 1; d <= reach && static_cast<int>(y) >= d; ++d) {
+            size_t i = rowStart[y - d];
+            size_t iEnd = rowStart[y - d + 1];
+            size_t j = rowStart[y];
+            size_t jEnd = rowStart[y + 1];
+            while (i < iEnd && j < jEnd) {
+                const Run& upper = runs[i];
+                const Run& lower = runs[j];
+                if (static_cast<int64_t>(upper.x1) + reach < lower.x0) {
+                    ++i;
+                } else if (static_cast<int64_t>(lower.x1) + reach < upper.x0) {
+                    ++j;
+                } else {
+                    components.unite(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+                    if (upper.x1 < lower.x1) ++i; else ++j;
+                }
+            }
+        }
+    }
+
+    // Number the components in scan order and bucket their runs together
+    std::vector<uint32_t> componentOf(runs.size());
+    std::vector<uint32_t> idOfRoot(runs.size(), UINT32_MAX);
+    uint32_t componentCount = 0;
+    for (size_t k = 0; k < runs.size(); ++k) {
+        uint32_t root = components.find(static_cast<uint32_t>(k));
+        if (idOfRoot[root] == UINT32_MAX) {
+            idOfRoot[root] = componentCount++;
+        }
+        componentOf[k] = idOfRoot[root];
+    }
+
+    std::vector<size_t> firstRun(componentCount + 1, 0);
+    for (uint32_t id : componentOf) {
+        ++firstRun[id + 1];
+    }
+    std::partial_sum(firstRun.begin(), firstRun.end(), firstRun.begin());
+    std::vector<uint32_t> order(runs.size());
+    std::vector<size_t> fill(firstRun.begin(), firstRun.end() - 1);
+    for (size_t k = 0; k < runs.size(); ++k) {
+        order[fill[componentOf[k]]++] = static_cast<uint32_t>(k);
+    }
+
+    // Names live in the table, so objects are counted by name address and
+    // only the distinct names are copied into the sorted result
+    result.objects.reserve(componentCount);
+    std::unordered_map<const std::string*, uint64_t> counts;
+    std::vector<std::pair<int, int>> cells;
+    for (uint32_t id = 0; id < componentCount; ++id) {
+        unsigned int minX = UINT32_MAX;
+        unsigned int maxX = 0;
+        unsigned int minY = UINT32_MAX;
+        unsigned int maxY = 0;
+        for (size_t k = firstRun[id]; k < firstRun[id + 1]; ++k) {
+            const Run& run = runs[order[k]];
+            minX = std::min(minX, run.x0);
+            maxX = std::max(maxX, run.x1);
+            minY = std::min(minY, run.y);
+            maxY = std::max(maxY, run.y);
+        }
+
+        cells.clear();
+        for (size_t k = firstRun[id]; k < firstRun[id + 1]; ++k) {
+            const Run& run = runs[order[k]];
+            for (unsigned int x = run.x0; x <= run.x1; ++x) {
+                cells.emplace_back(static_cast<int>(x - minX), static_cast<int>(run.y - minY));
+            }
+        }
+
+        uint64_t hash = canonicalHash(cells);
+        const std::string& name = nameFor(hash, cells);
+        ++counts[&name];
+        result.objects.push_back({name, hash, minX, minY, maxX - minX + 1, maxY - minY + 1,
+                                  static_cast<unsigned int>(cells.size())});
+    }
+
+    for (const auto& entry : counts) {
+        result.counts[*entry.first] = entry.second;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef CENSUS_HPP
+#define CENSUS_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Grid;
+class PatternManager;
+struct Pattern;
+
+struct CensusObject {
+    std::string name;
+    uint64_t hash;            // Canonical hash, the same for every orientation
+    unsigned int x;           // Bounding box in grid coordinates
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+    unsigned int population;
+};
+
+struct CensusResult {
+    std::vector<CensusObject> objects;
+    std::map<std::string, uint64_t> counts;
+    double seconds = 0.0;
+};
+
+// Splits a settled grid into objects and names each one. Objects are groups
+// of live cells within CONNECT_DISTANCE of each other (cells further apart
+// can never interact), found with a union-find over the row runs of the
+// packed words. Each object is hashed in the orientation that minimises the
+// hash, so all 8 rotations and reflections share one table entry.
+class Census {
+public:
+    static constexpr int CONNECT_DISTANCE = 2;
+    static constexpr unsigned int MAX_PERIOD = 64;
+
+    // Builds the name table from every pattern the manager knows. Periodic
+    // patterns register all their phases.
+    explicit Census(const PatternManager& patterns);
+
+    void addObject(const std::string& name, const Pattern& pattern);
+
+    // Objects not in the table are named after their behaviour in isolation
+    // (e.g. xs14_1a2b3c4d for a 14-cell still life); the result is cached
+    CensusResult run(const Grid& grid);
+
+    static uint64_t canonicalHash(const std::vector<std::pair<int, int>>& cells);
+    size_t getKnownCount() const { return names.size(); }
+
+private:
+    std::unordered_map<uint64_t, std::string> names;
+
+    const std::string& nameFor(uint64_t hash, const std::vector<std::pair<int, int>>& cells);
+};
+
+#endif // CENSUS_HPP
@@ -0,0 +1,385 @@
+#include "Lifespan.hpp"
+#include "ObjectTracker.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/CounterRng.hpp"
+#include "../core/Grid.hpp"
+#include "../patterns/PatternManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+
+namespace {
+
+// Live cells this close to the edge make the universe grow
+constexpr unsigned int GROW_MARGIN = 32;
+// Bounds are measured this often; nothing travels more than half the grow
+// margin in between
+constexpr uint64_t MEASURE_INTERVAL = 16;
+// Spaceships this far beyond the rest of the pattern are counted and erased
+constexpr unsigned int ESCAPE_MARGIN = 16;
+constexpr unsigned int MIN_ARENA_SIZE = 256;
+// Depth of the band along each edge of the pattern watched for a repeating
+// front, and how many measurements (MEASURE_INTERVAL apart) are kept. A front
+// must repeat twice within the history, and the puffer train's period of 140
+// only lines up with the interval every 560 generations.
+constexpr unsigned int FRONT_DEPTH = 32;
+constexpr size_t FRONT_HISTORY = 128;
+
+const char* const EDGE_NAMES[4] = {"left", "right", "top", "bottom"};
+
+struct Bounds {
+    unsigned int minX;
+    unsigned int minY;
+    unsigned int maxX;
+    unsigned int maxY;
+    uint64_t population;
+};
+
+Bounds measure(const Grid& grid) {
+    Bounds bounds{grid.getWidth(), grid.getHeight(), 0, 0, 0};
+    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+        const uint64_t* row = grid.getRow(y);
+        for (unsigned int i = 0; i < grid.getWordsPerRow(); ++i) {
+            if (!row[i]) continue;
+            bounds.population += bitops::popcount(row[i]);
+            bounds.minX = std::min(bounds.minX, i * 64 + bitops::countTrailingZeros(row[i]));
+            bounds.maxX = std::max(bounds.maxX, i * 64 + bitops::highestSetBit(row[i]));
+            bounds.minY = std::min(bounds.minY, y);
+            bounds.maxY = y;
+        }
+    }
+    return bounds;
+}
+
+// The band along each edge of the pattern (departing spaceships excluded):
+// where the edge is, and a hash of the band's cells relative to the band itself
+struct FrontSample {
+    uint64_t generation;
+    int64_t edges[4];
+    uint64_t hashes[4];
+};
+
+FrontSample sampleFront(const Grid& grid, const std::vector<TrackedObject>& objects, uint64_t generation) {
+    FrontSample sample{generation, {0, 0, 0, 0}, {0, 0, 0, 0}};
+    bool empty = true;
+    int64_t& minX = sample.edges[0];
+    int64_t& maxX = sample.edges[1];
+    int64_t& minY = sample.edges[2];
+    int64_t& maxY = sample.edges[3];
+    auto include = [&](const TrackedObject& object) {
+        int64_t right = object.x + object.width - 1;
+        int64_t bottom = object.y + object.height - 1;
+        minX = empty ? object.x : std::min<int64_t>(minX, object.x);
+        minY = empty ? object.y : std::min<int64_t>(minY, object.y);
+        maxX = empty ? right : std::max(maxX, right);
+        maxY = empty ? bottom : std::max(maxY, bottom);
+        empty = false;
+    };
+    for (const TrackedObject& object : objects) {
+        if (object.kind != ObjectKind::Spaceship) include(object);
+    }
+    if (empty) return sample;
+
+    // Spaceships within reach of the rest travel with it, like the escorts
+    // of a puffer train; the ones leaving are past the escape margin soon
+    const int64_t reachLeft = minX - ESCAPE_MARGIN;
+    const int64_t reachTop = minY - ESCAPE_MARGIN;
+    const int64_t reachRight = maxX + ESCAPE_MARGIN;
+    const int64_t reachBottom = maxY + ESCAPE_MARGIN;
+    for (const TrackedObject& object : objects) {
+        if (object.kind != ObjectKind::Spaceship) continue;
+        if (object.x > reachRight || object.y > reachBottom ||
+            object.x + object.width - 1 < reachLeft || object.y + object.height - 1 < reachTop) {
+            continue;
+        }
+        include(object);
+    }
+
+    std::vector<std::pair<int64_t, int64_t>> bands[4];
+    for (int64_t y = minY; y <= maxY; ++y) {
+        const uint64_t* row = grid.getRow(static_cast<unsigned int>(y));
+        for (int64_t i = minX / 64; i <= maxX / 64; ++i) {
+            for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                int64_t x = i * 64 + bitops::countTrailingZeros(bits);
+                if (x < minX || x > maxX) continue;
+                if (x < minX + FRONT_DEPTH) bands[0].emplace_back(x, y);
+                if (x > maxX - FRONT_DEPTH) bands[1].emplace_back(x, y);
+                if (y < minY + FRONT_DEPTH) bands[2].emplace_back(x, y);
+                if (y > maxY - FRONT_DEPTH) bands[3].emplace_back(x, y);
+            }
+        }
+    }
+
+    for (int edge = 0; edge < 4; ++edge) {
+        int64_t left = maxX;
+        int64_t top = maxY;
+        for (const auto& cell : bands[edge]) {
+            left = std::min(left, cell.first);
+            top = std::min(top, cell.second);
+        }
+        uint64_t hash = 0;
+        for (const auto& cell : bands[edge]) {
+            hash ^= counterrng::at(static_cast<uint64_t>(cell.first - left) << 32 | static_cast<uint64_t>(cell.second - top),
+                                   static_cast<uint64_t>(edge));
+        }
+        sample.hashes[edge] = hash;
+    }
+    return sample;
+}
+
+std::string describeFront(const std::deque<FrontSample>& fronts) {
+    // The latest front must match the ones `lag` and 2 * `lag` measurements
+    // earlier, having moved the same distance both times
+    const FrontSample& latest = fronts.back();
+    for (size_t lag = 1; lag * 2 < fronts.size(); ++lag) {
+        const FrontSample& middle = fronts[fronts.size() - 1 - lag];
+        const FrontSample& oldest = fronts[fronts.size() - 1 - lag * 2];
+        for (int edge = 0; edge < 4; ++edge) {
+            int64_t step = latest.edges[edge] - middle.edges[edge];
+            if (step == 0 || middle.edges[edge] - oldest.edges[edge] != step) continue;
+            if (latest.hashes[edge] != middle.hashes[edge] || middle.hashes[edge] != oldest.hashes[edge]) continue;
+            return std::string(EDGE_NAMES[edge]) + " edge advances " + std::to_string(std::abs(step)) +
+                   " cells every " + std::to_string(latest.generation - middle.generation) +
+                   " generations with the same cells behind it (puffer, switch engine, breeder or spacefiller)";
+        }
+    }
+    return "";
+}
+
+bool isGlider(const TrackedObject& object) {
+    return object.population == 5 && object.period == 4 && std::abs(object.dx) == 1 && std::abs(object.dy) == 1;
+}
+
+// Copies the universe into the middle of one twice its size. The offset is a
+// multiple of 64, so every row moves as whole words.
+std::unique_ptr<Grid> grow(const Grid& grid, unsigned int offset) {
+    auto larger = std::make_unique<Grid>(grid.getWidth() * 2, grid.getHeight() * 2);
+    const unsigned int wordOffset = offset / 64;
+    larger->generateRows([&grid, offset, wordOffset](unsigned int y, uint64_t* row) {
+        if (y < offset || y >= offset + grid.getHeight()) return;
+        const uint64_t* source = grid.getRow(y - offset);
+        std::copy(source, source + grid.getWordsPerRow(), row + wordOffset);
+    });
+    larger->setGeneration(grid.getGeneration());
+    larger->clearChanges();
+    return larger;
+}
+
+} // namespace
+
+Lifespan::Lifespan(const LifespanConfig& config)
+    : config(config) {
+}
+
+LifespanResult Lifespan::run(const Pattern& pattern) const {
+    auto startTime = std::chrono::steady_clock::now();
+    LifespanResult result;
+
+    unsigned int side = MIN_ARENA_SIZE;
+    while (side < std::max(pattern.width, pattern.height) * 2 + GROW_MARGIN * 4) {
+        side *= 2;
+    }
+    if (side > config.maxArenaSize) {
+        result.diagnosis = "pattern does not fit in a " + std::to_string(config.maxArenaSize) + " cell universe";
+        return result;
+    }
+
+    auto grid = std::make_unique<Grid>(side, side);
+    grid->blit(pattern.rows.data(), pattern.wordsPerRow, pattern.width, pattern.height,
+               (side - pattern.width) / 2, (side - pattern.height) / 2);
+    ObjectTracker tracker(config.maxPeriod);
+    tracker.observe(*grid);
+    grid->clearChanges();
+
+    // Recent universe hashes, with the escape count at the time, for
+    // spotting the first repeat
+    struct Sample {
+        uint64_t generation;
+        uint64_t hash;
+        uint64_t spaceships;
+    };
+    std::deque<Sample> history;
+    std::vector<std::pair<uint64_t, uint64_t>> populations;
+    std::deque<FrontSample> fronts;
+    // An advancing front, once found, and the generation it was found at
+    std::string front;
+    uint64_t frontGeneration = 0;
+
+    while (true) {
+        const uint64_t generation = grid->getGeneration();
+
+        if (generation % MEASURE_INTERVAL == 0) {
+            Bounds bounds = measure(*grid);
+            populations.emplace_back(generation, bounds.population);
+            if (bounds.population > config.maxPopulation) {
+                result.outcome = LifespanOutcome::UnboundedGrowth;
+                result.diagnosis = "population passed " + std::to_string(config.maxPopulation) + "; " +
+                                   (front.empty() ? "" : front + "; ") + describeGrowth(populations);
+                break;
+            }
+            if (bounds.population > 0 &&
+                (bounds.minX < GROW_MARGIN || bounds.minY < GROW_MARGIN ||
+                 bounds.maxX + GROW_MARGIN >= side || bounds.maxY + GROW_MARGIN >= side)) {
+                if (side * 2 > config.maxArenaSize) {
+                    result.outcome = LifespanOutcome::UnboundedGrowth;
+                    result.diagnosis = "outgrew a " + std::to_string(config.maxArenaSize) + " cell universe; " +
+                                       (front.empty() ? "" : front + "; ") + describeGrowth(populations);
+                    break;
+                }
+                grid = grow(*grid, side / 2);
+                tracker.rebase(side / 2, side / 2, side * 2, side * 2);
+                for (FrontSample& front : fronts) {
+                    for (int64_t& edge : front.edges) {
+                        edge += side / 2;
+                    }
+                }
+                side *= 2;
+                history.clear(); // The hash depends on position
+            }
+
+            // An edge that keeps advancing with the same cells behind it is
+            // a puffer, engine or spacefiller: it will never stop
+            if (front.empty()) {
+                fronts.push_back(sampleFront(*grid, tracker.getObjects(), generation));
+                if (fronts.size() > FRONT_HISTORY) {
+                    fronts.pop_front();
+                }
+                front = describeFront(fronts);
+                frontGeneration = generation;
+            }
+            // Linear and quadratic growth are only told apart over a doubling
+            // of the age (a puffer's smoke can spread for a while), so the run
+            // goes on until then
+            if (!front.empty() && generation >= frontGeneration * 2) {
+                result.outcome = LifespanOutcome::UnboundedGrowth;
+                result.diagnosis = front + "; " + describeGrowth(populations);
+                break;
+            }
+        }
+
+        const uint64_t hash = grid->getHash();
+        auto repeat = std::find_if(history.rbegin(), history.rend(),
+                                   [hash](const Sample& sample) { return sample.hash == hash; });
+        if (repeat != history.rend()) {
+            result.period = static_cast<unsigned int>(generation - repeat->generation);
+            uint64_t emitted = result.spaceships - repeat->spaceships;
+            if (emitted > 0) {
+                result.outcome = LifespanOutcome::UnboundedGrowth;
+                result.diagnosis = "gun: emits " + std::to_string(emitted) + " spaceship" +
+                                   (emitted == 1 ? "" : "s") + " every " + std::to_string(result.period) +
+                                   " generations";
+                break;
+            }
+
+            // Settled when the last object took its final form or vanished
+            uint64_t settled = tracker.getLastVanished();
+            for (const TrackedObject& object : tracker.getObjects()) {
+                settled = std::max(settled, object.stableSince);
+            }
+            result.outcome = LifespanOutcome::Stabilized;
+            result.stabilizationGeneration = std::min(settled, repeat->generation);
+            result.finalPopulation = measure(*grid).population;
+            break;
+        }
+        history.push_back({generation, hash, result.spaceships});
+        if (history.size() > config.maxPeriod) {
+            history.pop_front();
+        }
+
+        if (generation >= config.maxGenerations) {
+            result.diagnosis = "still evolving after " + std::to_string(generation) + " generations; " +
+                               describeGrowth(populations);
+            break;
+        }
+
+        grid->nextGeneration();
+        tracker.observe(*grid);
+        grid->clearChanges();
+        removeEscapees(*grid, tracker, result);
+    }
+
+    result.generations = grid->getGeneration();
+    result.arenaSize = side;
+    if (result.outcome != LifespanOutcome::Stabilized) {
+        result.finalPopulation = measure(*grid).population;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+void Lifespan::removeEscapees(Grid& grid, ObjectTracker& tracker, LifespanResult& result) const {
+    std::vector<TrackedObject> objects = tracker.getObjects();
+
+    // Everything but the spaceships
+    bool haveCore = false;
+    Bounds core{0, 0, 0, 0, 0};
+    for (const TrackedObject& object : objects) {
+        if (object.kind == ObjectKind::Spaceship) continue;
+        unsigned int right = object.x + object.width - 1;
+        unsigned int bottom = object.y + object.height - 1;
+        if (!haveCore) {
+            core = {object.x, object.y, right, bottom, 0};
+            haveCore = true;
+            continue;
+        }
+        core.minX = std::min(core.minX, object.x);
+        core.minY = std::min(core.minY, object.y);
+        core.maxX = std::max(core.maxX, right);
+        core.maxY = std::max(core.maxY, bottom);
+    }
+
+    // A spaceship clear of the core on an axis it is moving away along can
+    // never come back
+    bool removed = false;
+    for (const TrackedObject& object : objects) {
+        if (object.kind != ObjectKind::Spaceship) continue;
+        unsigned int right = object.x + object.width - 1;
+        unsigned int bottom = object.y + object.height - 1;
+        bool escaped = !haveCore ||
+                       (object.dx > 0 && object.x > core.maxX + ESCAPE_MARGIN) ||
+                       (object.dx < 0 && right + ESCAPE_MARGIN < core.minX) ||
+                       (object.dy > 0 && object.y > core.maxY + ESCAPE_MARGIN) ||
+                       (object.dy < 0 && bottom + ESCAPE_MARGIN < core.minY);
+        if (!escaped) continue;
+
+        ++result.spaceships;
+        result.gliders += isGlider(object) ? 1 : 0;
+        result.escapedCells += object.population;
+        tracker.forget(object.id);
+        grid.fillRect(object.x, object.y, object.width, object.height, false);
+        removed = true;
+    }
+
+    if (removed) {
+        tracker.observe(grid);
+        grid.clearChanges();
+    }
+}
+
+std::string Lifespan::describeGrowth(const std::vector<std::pair<uint64_t, uint64_t>>& populations) {
+    if (populations.empty()) {
+        return "no population samples";
+    }
+
+    // Growth exponent between the latest sample and the one at half its age
+    const auto& latest = populations.back();
+    auto earlier = std::find_if(populations.rbegin(), populations.rend(),
+                                [&latest](const auto& sample) { return sample.first * 2 <= latest.first; });
+    std::string description = "population " + std::to_string(latest.second);
+    if (earlier == populations.rend() || earlier->first == 0 || earlier->second == 0 || latest.second == 0) {
+        return description;
+    }
+
+    double exponent = std::log(static_cast<double>(latest.second) / static_cast<double>(earlier->second)) /
+                      std::log(static_cast<double>(latest.first) / static_cast<double>(earlier->first));
+    if (exponent > 1.5) {
+        return description + ", growing quadratically (breeder or spacefiller)";
+    }
+    if (exponent > 0.5) {
+        return description + ", growing linearly (gun, puffer or switch engine)";
+    }
+    return description + ", not growing";
+}
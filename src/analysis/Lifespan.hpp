@@ -0,0 +1,64 @@
+#ifndef LIFESPAN_HPP
+#define LIFESPAN_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Grid;
+class ObjectTracker;
+struct Pattern;
+
+struct LifespanConfig {
+    uint64_t maxGenerations = 100000;
+    uint64_t maxPopulation = 1000000;   // Growth past this is diagnosed as unbounded
+    unsigned int maxArenaSize = 8192;   // Side the universe may grow to
+    unsigned int maxPeriod = 64;        // Longest period recognised as stable
+};
+
+enum class LifespanOutcome {
+    Stabilized,        // Periodic from stabilizationGeneration on (possibly empty)
+    UnboundedGrowth,   // Gun, puffer or breeder; see diagnosis
+    GenerationLimit    // Still evolving after maxGenerations
+};
+
+struct LifespanResult {
+    LifespanOutcome outcome = LifespanOutcome::GenerationLimit;
+    uint64_t stabilizationGeneration = 0;
+    uint64_t generations = 0;        // Generations simulated
+    unsigned int period = 0;         // Period of the final state
+    uint64_t finalPopulation = 0;    // Cells left behind, escaped spaceships excluded
+    uint64_t gliders = 0;            // Gliders that escaped
+    uint64_t spaceships = 0;         // All escaped spaceships, gliders included
+    uint64_t escapedCells = 0;       // Cells in the escaped spaceships
+    unsigned int arenaSize = 0;      // Side of the universe when the run ended
+    std::string diagnosis;
+    double seconds = 0.0;
+};
+
+// Measures how long a pattern (typically a methuselah) takes to settle. The
+// pattern runs in a universe that doubles in size whenever live cells near
+// its edge, so it behaves as if unbounded. Spaceships that have cleared the
+// rest of the pattern and are moving away are counted and erased, as they
+// can never interact again; the run ends when the remaining cells repeat.
+//
+// A state that repeats while still emitting spaceships is a gun, and an edge
+// that keeps advancing with the same cells behind it is a puffer, engine or
+// spacefiller; either ends the run early (the latter once the run is twice
+// as old, to measure the growth rate). A pattern outgrowing maxArenaSize or
+// maxPopulation is diagnosed from the shape of its population curve.
+class Lifespan {
+public:
+    explicit Lifespan(const LifespanConfig& config = LifespanConfig());
+
+    LifespanResult run(const Pattern& pattern) const;
+
+private:
+    LifespanConfig config;
+
+    void removeEscapees(Grid& grid, ObjectTracker& tracker, LifespanResult& result) const;
+    static std::string describeGrowth(const std::vector<std::pair<uint64_t, uint64_t>>& populations);
+};
+
+#endif // LIFESPAN_HPP
@@ -0,0 +1,594 @@
+#include "ObjectTracker.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/Grid.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <unordered_set>
+
+namespace {
+
+// Side of the squares the spatial index is bucketed by
+constexpr unsigned int BUCKET_SIZE = 16;
+// Cells up to two apart can influence a common neighbour (see Census)
+constexpr unsigned int REACH = 2;
+
+uint64_t bucketKey(unsigned int bx, unsigned int by) {
+    return (static_cast<uint64_t>(by) << 32) | bx;
+}
+
+// First and last bucket column and row a box covers
+std::array<unsigned int, 4> bucketSpan(unsigned int x, unsigned int y, unsigned int width, unsigned int height) {
+    return {x / BUCKET_SIZE, y / BUCKET_SIZE, (x + width - 1) / BUCKET_SIZE, (y + height - 1) / BUCKET_SIZE};
+}
+
+} // namespace
+
+std::string TrackedObject::getSpeed() const {
+    if (kind == ObjectKind::Unclassified || period == 0) {
+        return "unknown";
+    }
+    if (dx == 0 && dy == 0) {
+        return period == 1 ? "still" : "p" + std::to_string(period);
+    }
+
+    const int distance = std::max(std::abs(dx), std::abs(dy));
+    const int divisor = std::gcd(distance, static_cast<int>(period));
+    const int cells = distance / divisor;
+    const int generations = static_cast<int>(period) / divisor;
+
+    std::string speed = cells == 1 ? "c" : std::to_string(cells) + "c";
+    if (generations != 1) {
+        speed += "/" + std::to_string(generations);
+    }
+    if (dx == 0 || dy == 0) {
+        return speed + " orthogonal";
+    }
+    if (std::abs(dx) == std::abs(dy)) {
+        return speed + " diagonal";
+    }
+    return speed + " oblique (" + std::to_string(dx) + "," + std::to_string(dy) + ")";
+}
+
+ObjectTracker::ObjectTracker(unsigned int maxPeriod)
+    : maxPeriod(std::max(maxPeriod, 1u)),
+      primed(false),
+      width(0),
+      height(0),
+      generation(0),
+      nextId(1),
+      lastVanished(0) {
+}
+
+void ObjectTracker::reset() {
+    primed = false;
+    lastVanished = 0;
+    tracks.clear();
+    buckets.clear();
+    visited.clear();
+}
+
+void ObjectTracker::observe(const Grid& grid) {
+    if (primed && (grid.getWidth() != width || grid.getHeight() != height)) {
+        reset();
+    }
+
+    generation = grid.getGeneration();
+    const bool fullScan = !primed;
+    if (!fullScan && !grid.hasChanges()) {
+        return; // Nothing moved, so every track keeps its state
+    }
+
+    const unsigned int wordsPerRow = grid.getWordsPerRow();
+    if (fullScan) {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        visited.assign(static_cast<size_t>(wordsPerRow) * height, 0);
+        primed = true;
+    }
+
+    // Seeds are the live cells the components are grown from: every live cell
+    // on the first pass, afterwards the cells born since and the cells of the
+    // tracks that are re-examined
+    std::vector<std::pair<unsigned int, unsigned int>> seeds;
+    std::vector<uint64_t> touched;
+    std::unordered_set<uint64_t> touchedIds;
+    auto seedRange = [&](unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+        for (unsigned int y = y0; y <= y1; ++y) {
+            const uint64_t* row = grid.getRow(y);
+            for (unsigned int i = x0 / 64; i <= x1 / 64; ++i) {
+                uint64_t bits = row[i];
+                if (i == x0 / 64) bits &= ~bitops::lowMask(x0 % 64);
+                if (i == x1 / 64) bits &= bitops::lowMask(x1 % 64 + 1);
+                for (; bits; bits &= bits - 1) {
+                    seeds.emplace_back(i * 64 + bitops::countTrailingZeros(bits), y);
+                }
+            }
+        }
+    };
+    // Every live cell of a touched track must land in some component, or the
+    // track would be mistaken for one that died
+    auto touch = [&](uint64_t id) {
+        if (!touchedIds.insert(id).second) return;
+        touched.push_back(id);
+        const TrackedObject& object = tracks.at(id).object;
+        seedRange(object.x, object.y, object.x + object.width - 1, object.y + object.height - 1);
+    };
+
+    if (fullScan) {
+        if (width > 0 && height > 0) {
+            seedRange(0, 0, width - 1, height - 1);
+        }
+    } else {
+        // A cell that died lay in the box of its track, so the tracks whose
+        // boxes cover a change are the ones to re-examine. The changes are
+        // gathered per bucket with the box they span, so a busy area costs
+        // one index lookup per bucket rather than one per changed word.
+        struct Change {
+            uint64_t key;
+            unsigned int x0;
+            unsigned int y0;
+            unsigned int x1;
+            unsigned int y1;
+        };
+        std::vector<Change> changes;
+        for (unsigned int y = grid.getChangedTop(); y <= grid.getChangedBottom(); ++y) {
+            if (!grid.isRowChanged(y)) continue;
+            const uint64_t* changed = grid.getChangedRow(y);
+            const uint64_t* row = grid.getRow(y);
+            for (unsigned int i = 0; i < wordsPerRow; ++i) {
+                if (!changed[i]) continue;
+                for (uint64_t born = changed[i] & row[i]; born; born &= born - 1) {
+                    seeds.emplace_back(i * 64 + bitops::countTrailingZeros(born), y);
+                }
+                unsigned int first = i * 64 + bitops::countTrailingZeros(changed[i]);
+                unsigned int last = i * 64 + bitops::highestSetBit(changed[i]);
+                for (unsigned int bx = first / BUCKET_SIZE; bx <= last / BUCKET_SIZE; ++bx) {
+                    changes.push_back({bucketKey(bx, y / BUCKET_SIZE), std::max(first, bx * BUCKET_SIZE), y,
+                                       std::min(last, bx * BUCKET_SIZE + BUCKET_SIZE - 1), y});
+                }
+            }
+        }
+        std::sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) { return a.key < b.key; });
+
+        for (size_t begin = 0; begin < changes.size();) {
+            Change box = changes[begin];
+            size_t end = begin + 1;
+            for (; end < changes.size() && changes[end].key == box.key; ++end) {
+                box.x0 = std::min(box.x0, changes[end].x0);
+                box.y0 = std::min(box.y0, changes[end].y0);
+                box.x1 = std::max(box.x1, changes[end].x1);
+                box.y1 = std::max(box.y1, changes[end].y1);
+            }
+            begin = end;
+
+            auto it = buckets.find(box.key);
+            if (it == buckets.end()) continue;
+            for (uint64_t id : it->second) {
+                const TrackedObject& object = tracks.at(id).object;
+                if (object.x <= box.x1 && object.x + object.width - 1 >= box.x0 &&
+                    object.y <= box.y1 && object.y + object.height - 1 >= box.y0) {
+                    touch(id);
+                }
+            }
+        }
+    }
+
+    // Grow components until they reach no further tracks. A component can
+    // reach into objects away from the changes (a glider hitting a block);
+    // those tracks are re-examined too, and their cells seed more components.
+    std::vector<Component> components;
+    std::vector<std::vector<uint64_t>> overlapping;
+    while (!seeds.empty()) {
+        std::vector<std::pair<unsigned int, unsigned int>> pending;
+        pending.swap(seeds);
+        size_t first = components.size();
+        for (const auto& seed : pending) {
+            if (!((visited[static_cast<size_t>(seed.second) * wordsPerRow + seed.first / 64] >> (seed.first % 64)) & 1ULL)) {
+                components.push_back(extractComponent(grid, seed.first, seed.second));
+            }
+        }
+        overlapping.resize(components.size());
+        for (size_t c = first; c < components.size(); ++c) {
+            const Component& component = components[c];
+            collectTracks(component.minX, component.minY, component.maxX, component.maxY, overlapping[c]);
+            for (uint64_t id : overlapping[c]) {
+                touch(id);
+            }
+        }
+    }
+
+    // Pair components with the tracks they overlap, best pairs first. A track
+    // that has had the component's shape before is the best match (an object
+    // that a spaceship brushed past keeps its identity), then the largest
+    // overlap of the boxes.
+    std::vector<uint64_t> hashes(components.size());
+    struct Pairing {
+        uint64_t score;
+        size_t component;
+        uint64_t id;
+    };
+    std::vector<Pairing> pairings;
+    for (size_t c = 0; c < components.size(); ++c) {
+        const Component& component = components[c];
+        hashes[c] = hashComponent(component);
+        for (uint64_t id : overlapping[c]) {
+            const Track& track = tracks.at(id);
+            const TrackedObject& object = track.object;
+            uint64_t left = std::max(component.minX, object.x);
+            uint64_t right = std::min(component.maxX, object.x + object.width - 1);
+            uint64_t top = std::max(component.minY, object.y);
+            uint64_t bottom = std::min(component.maxY, object.y + object.height - 1);
+            // Boxes within reach but not overlapping still count, just barely
+            uint64_t score = (left <= right && top <= bottom) ? (right - left + 1) * (bottom - top + 1) + 1 : 1;
+            bool seen = std::any_of(track.history.rbegin(), track.history.rend(),
+                                    [&hashes, c](const Phase& phase) { return phase.hash == hashes[c]; });
+            if (seen) {
+                score += 1ULL << 40;
+            }
+            pairings.push_back({score, c, id});
+        }
+    }
+    std::sort(pairings.begin(), pairings.end(), [](const Pairing& a, const Pairing& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.component != b.component ? a.component < b.component : a.id < b.id;
+    });
+
+    std::unordered_set<uint64_t> claimed;
+    std::vector<uint64_t> continues(components.size(), 0);
+    for (const Pairing& pairing : pairings) {
+        if (continues[pairing.component] || claimed.count(pairing.id)) continue;
+        claimed.insert(pairing.id);
+        continues[pairing.component] = pairing.id;
+    }
+
+    // A component left without a track may be an object that merged into a
+    // neighbour and has split off again in the same place (two objects whose
+    // phases alternately touch); it gets its old track back
+    std::vector<std::unique_ptr<Track>> revived(components.size());
+    for (size_t c = 0; c < components.size(); ++c) {
+        if (continues[c]) continue;
+        const Component& component = components[c];
+        for (uint64_t id : overlapping[c]) {
+            std::vector<Track>& absorbed = tracks.at(id).absorbed;
+            auto match = std::find_if(absorbed.begin(), absorbed.end(), [&](const Track& track) {
+                return std::any_of(track.history.begin(), track.history.end(), [&](const Phase& phase) {
+                    return phase.hash == hashes[c] && phase.x == component.minX && phase.y == component.minY;
+                });
+            });
+            if (match != absorbed.end()) {
+                revived[c] = std::make_unique<Track>(std::move(*match));
+                absorbed.erase(match);
+                break;
+            }
+        }
+    }
+
+    // A track left alone for a generation or more did not change in between,
+    // so it has been a still life since (as getObjects reports it). Its state
+    // says so before it is examined again, so a cycle interrupted later (or
+    // an object that merges and splits off again) resumes from there.
+    auto settle = [this](Track& track) {
+        if (track.lastChanged + 1 >= generation || track.history.empty()) return;
+        TrackedObject& object = track.object;
+        if (object.kind != ObjectKind::StillLife) {
+            object.kind = ObjectKind::StillLife;
+            object.period = 1;
+            object.dx = 0;
+            object.dy = 0;
+            object.stableSince = track.lastChanged;
+        }
+        track.history.back().cyclic = true;
+        track.cyclePeriod = 1;
+        track.cycleSince = object.stableSince;
+        track.lastChanged = generation - 1;
+    };
+
+    // Touched tracks that no component continues merged into a neighbour or
+    // died. They leave the index now; the continued ones are updated in place.
+    std::vector<Track> leftover;
+    for (uint64_t id : touched) {
+        if (claimed.count(id)) continue;
+        auto it = tracks.find(id);
+        settle(it->second);
+        indexTrack(it->second, false);
+        leftover.push_back(std::move(it->second));
+        tracks.erase(it);
+    }
+
+    for (size_t c = 0; c < components.size(); ++c) {
+        const Component& component = components[c];
+        Track* continued = continues[c] ? &tracks.at(continues[c]) : nullptr;
+        if (continued) {
+            settle(*continued);
+        } else {
+            Track fresh;
+            if (revived[c]) {
+                fresh = std::move(*revived[c]);
+            } else {
+                fresh.object.id = nextId++;
+            }
+            const uint64_t id = fresh.object.id;
+            continued = &tracks.emplace(id, std::move(fresh)).first->second;
+        }
+        Track& track = *continued;
+        // A track only moves in the index when its box crosses into other buckets
+        const bool indexed = continues[c] != 0;
+        const bool rebucket = !indexed ||
+                              bucketSpan(track.object.x, track.object.y, track.object.width, track.object.height) !=
+                                  bucketSpan(component.minX, component.minY, component.maxX - component.minX + 1,
+                                             component.maxY - component.minY + 1);
+        if (indexed && rebucket) {
+            indexTrack(track, false);
+        }
+        // Absorbed tracks are only worth keeping while their phases could recur
+        track.absorbed.erase(std::remove_if(track.absorbed.begin(), track.absorbed.end(),
+                                            [this](const Track& absorbed) {
+                                                return generation - absorbed.lastChanged > maxPeriod;
+                                            }),
+                             track.absorbed.end());
+
+        TrackedObject& object = track.object;
+        object.x = component.minX;
+        object.y = component.minY;
+        object.width = component.maxX - component.minX + 1;
+        object.height = component.maxY - component.minY + 1;
+        object.population = static_cast<unsigned int>(component.cells.size());
+
+        Phase phase{generation, hashes[c], component.minX, component.minY, false};
+        if (!track.history.empty() && track.history.back().generation == generation) {
+            track.history.pop_back(); // Edited again within the same generation
+        }
+        // The newest phase is kept however old: the object has not changed since
+        while (track.history.size() > 1 && generation - track.history.front().generation > maxPeriod) {
+            track.history.pop_front();
+        }
+
+        const TrackedObject before = object;
+        object.kind = ObjectKind::Unclassified;
+        object.period = 0;
+        object.dx = 0;
+        object.dy = 0;
+        uint64_t cycleStart = generation;
+        bool resumed = false;
+        if (track.cyclePeriod > 0) {
+            // Back in step with the last stationary cycle, e.g. after a
+            // spaceship brushed past: the cycle was never broken
+            for (auto it = track.history.rbegin(); it != track.history.rend(); ++it) {
+                if (it->generation < track.cycleSince) break;
+                if (it->cyclic && it->hash == phase.hash && it->x == phase.x && it->y == phase.y &&
+                    (generation - it->generation) % track.cyclePeriod == 0) {
+                    object.period = track.cyclePeriod;
+                    object.kind = object.period == 1 ? ObjectKind::StillLife : ObjectKind::Oscillator;
+                    cycleStart = track.cycleSince;
+                    resumed = true;
+                    break;
+                }
+            }
+        }
+        if (!resumed && !revived[c] && !track.history.empty() && track.history.back().hash == phase.hash &&
+            track.history.back().x == phase.x && track.history.back().y == phase.y) {
+            // Unchanged since it was last looked at, however long ago (a
+            // revived track was part of its neighbour in between)
+            object.kind = ObjectKind::StillLife;
+            object.period = 1;
+            cycleStart = track.history.back().generation;
+        } else if (!resumed) {
+            // The most recent earlier phase with the same shape gives the period
+            for (auto it = track.history.rbegin(); it != track.history.rend(); ++it) {
+                if (it->hash != phase.hash) continue;
+                object.period = static_cast<unsigned int>(generation - it->generation);
+                object.dx = static_cast<int>(phase.x) - static_cast<int>(it->x);
+                object.dy = static_cast<int>(phase.y) - static_cast<int>(it->y);
+                if (object.dx != 0 || object.dy != 0) {
+                    object.kind = ObjectKind::Spaceship;
+                } else {
+                    object.kind = object.period == 1 ? ObjectKind::StillLife : ObjectKind::Oscillator;
+                }
+                cycleStart = it->generation;
+                break;
+            }
+        }
+
+        // A cycle that merely continues keeps its start
+        bool sameCycle = !resumed && object.period != 0 && before.period == object.period &&
+                         before.dx == object.dx && before.dy == object.dy;
+        object.stableSince = sameCycle ? before.stableSince : cycleStart;
+        if (object.kind == ObjectKind::StillLife || object.kind == ObjectKind::Oscillator) {
+            phase.cyclic = true;
+            track.cyclePeriod = object.period;
+            track.cycleSince = object.stableSince;
+        } else if (object.kind == ObjectKind::Spaceship) {
+            track.cyclePeriod = 0;
+        }
+
+        track.history.push_back(phase);
+        track.lastChanged = generation;
+        if (rebucket) {
+            indexTrack(track, true);
+        }
+    }
+    // Tracks left over either merged into a neighbour, which keeps them in
+    // case they split off again, or died
+    for (Track& track : leftover) {
+        const TrackedObject& object = track.object;
+        std::vector<uint64_t> nearby;
+        collectTracks(object.x, object.y, object.x + object.width - 1, object.y + object.height - 1, nearby);
+        if (nearby.empty()) {
+            lastVanished = generation;
+            continue;
+        }
+
+        std::vector<Track>& absorbed = tracks.at(nearby.front()).absorbed;
+        for (Track& inner : track.absorbed) {
+            absorbed.push_back(std::move(inner));
+        }
+        track.absorbed.clear();
+        absorbed.push_back(std::move(track));
+    }
+
+    for (const Component& component : components) {
+        for (const auto& cell : component.cells) {
+            visited[static_cast<size_t>(cell.second) * wordsPerRow + cell.first / 64] &= ~(1ULL << (cell.first % 64));
+        }
+    }
+}
+
+void ObjectTracker::forget(uint64_t id) {
+    auto it = tracks.find(id);
+    if (it == tracks.end()) return;
+    indexTrack(it->second, false);
+    tracks.erase(it);
+}
+
+void ObjectTracker::rebase(unsigned int offsetX, unsigned int offsetY, unsigned int newWidth, unsigned int newHeight) {
+    if (!primed) return;
+
+    width = newWidth;
+    height = newHeight;
+    visited.assign(static_cast<size_t>((newWidth + 63) / 64) * newHeight, 0);
+    buckets.clear();
+    auto shift = [offsetX, offsetY](Track& track) {
+        track.object.x += offsetX;
+        track.object.y += offsetY;
+        for (Phase& phase : track.history) {
+            phase.x += offsetX;
+            phase.y += offsetY;
+        }
+    };
+    for (auto& entry : tracks) {
+        shift(entry.second);
+        for (Track& absorbed : entry.second.absorbed) {
+            shift(absorbed);
+        }
+        indexTrack(entry.second, true);
+    }
+}
+
+std::vector<TrackedObject> ObjectTracker::getObjects() const {
+    std::vector<TrackedObject> objects;
+    objects.reserve(tracks.size());
+    for (const auto& entry : tracks) {
+        TrackedObject object = entry.second.object;
+        // Nothing near it has changed since it was last looked at, so it is
+        // a still life whatever it seemed to be doing then
+        if (entry.second.lastChanged < generation && object.kind != ObjectKind::StillLife) {
+            object.kind = ObjectKind::StillLife;
+            object.period = 1;
+            object.dx = 0;
+            object.dy = 0;
+            object.stableSince = entry.second.lastChanged;
+        }
+        objects.push_back(object);
+    }
+    std::sort(objects.begin(), objects.end(), [](const TrackedObject& a, const TrackedObject& b) {
+        return a.id < b.id;
+    });
+    return objects;
+}
+
+void ObjectTracker::indexTrack(const Track& track, bool add) {
+    const TrackedObject& object = track.object;
+    for (unsigned int by = object.y / BUCKET_SIZE; by <= (object.y + object.height - 1) / BUCKET_SIZE; ++by) {
+        for (unsigned int bx = object.x / BUCKET_SIZE; bx <= (object.x + object.width - 1) / BUCKET_SIZE; ++bx) {
+            if (add) {
+                buckets[bucketKey(bx, by)].push_back(object.id);
+                continue;
+            }
+            auto it = buckets.find(bucketKey(bx, by));
+            if (it == buckets.end()) continue;
+            auto& ids = it->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), object.id), ids.end());
+            if (ids.empty()) {
+                buckets.erase(it);
+            }
+        }
+    }
+}
+
+void ObjectTracker::collectTracks(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,
+                                  std::vector<uint64_t>& found) const {
+    // Widen the query by REACH so tracks close enough to interact are included
+    x0 = x0 >= REACH ? x0 - REACH : 0;
+    y0 = y0 >= REACH ? y0 - REACH : 0;
+    x1 += REACH;
+    y1 += REACH;
+
+    const size_t start = found.size();
+    for (unsigned int by = y0 / BUCKET_SIZE; by <= y1 / BUCKET_SIZE; ++by) {
+        for (unsigned int bx = x0 / BUCKET_SIZE; bx <= x1 / BUCKET_SIZE; ++bx) {
+            auto it = buckets.find(bucketKey(bx, by));
+            if (it == buckets.end()) continue;
+            for (uint64_t id : it->second) {
+                const TrackedObject& object = tracks.at(id).object;
+                if (object.x <= x1 && object.x + object.width - 1 >= x0 &&
+                    object.y <= y1 && object.y + object.height - 1 >= y0) {
+                    found.push_back(id);
+                }
+            }
+        }
+    }
+
+    // A track spanning several buckets is found once per bucket
+    std::sort(found.begin() + start, found.end());
+    found.erase(std::unique(found.begin() + start, found.end()), found.end());
+}
+
+ObjectTracker::Component ObjectTracker::extractComponent(const Grid& grid, unsigned int x, unsigned int y) {
+    const unsigned int wordsPerRow = grid.getWordsPerRow();
+    Component component{{}, x, y, x, y};
+    std::vector<std::pair<unsigned int, unsigned int>> stack{{x, y}};
+    visited[static_cast<size_t>(y) * wordsPerRow + x / 64] |= 1ULL << (x % 64);
+
+    while (!stack.empty()) {
+        auto cell = stack.back();
+        stack.pop_back();
+        component.cells.push_back(cell);
+        component.minX = std::min(component.minX, cell.first);
+        component.maxX = std::max(component.maxX, cell.first);
+        component.minY = std::min(component.minY, cell.second);
+        component.maxY = std::max(component.maxY, cell.second);
+
+        // Unvisited live cells within reach, a word at a time
+        unsigned int x0 = cell.first >= REACH ? cell.first - REACH : 0;
+        unsigned int y0 = cell.second >= REACH ? cell.second - REACH : 0;
+        unsigned int x1 = std::min(width - 1, cell.first + REACH);
+        unsigned int y1 = std::min(height - 1, cell.second + REACH);
+        for (unsigned int ny = y0; ny <= y1; ++ny) {
+            const uint64_t* row = grid.getRow(ny);
+            uint64_t* seen = &visited[static_cast<size_t>(ny) * wordsPerRow];
+            for (unsigned int i = x0 / 64; i <= x1 / 64; ++i) {
+                uint64_t bits = row[i] & ~seen[i];
+                if (i == x0 / 64) bits &= ~bitops::lowMask(x0 % 64);
+                if (i == x1 / 64) bits &= bitops::lowMask(x1 % 64 + 1);
+                seen[i] |= bits;
+                for (; bits; bits &= bits - 1) {
+                    stack.emplace_back(i * 64 + bitops::countTrailingZeros(bits), ny);
+                }
+            }
+        }
+    }
+    return component;
+}
+
+uint64_t ObjectTracker::hashComponent(const Component& component) {
+    // Pack the cells relative to the bounding box and hash the words the way
+    // the stepper hashes the grid, so the hash is independent of position
+    const unsigned int boxWidth = component.maxX - component.minX + 1;
+    const unsigned int boxHeight = component.maxY - component.minY + 1;
+    const unsigned int boxWords = (boxWidth + 63) / 64;
+    std::vector<uint64_t> words(static_cast<size_t>(boxWords) * boxHeight, 0);
+    for (const auto& cell : component.cells) {
+        unsigned int x = cell.first - component.minX;
+        unsigned int y = cell.second - component.minY;
+        words[static_cast<size_t>(y) * boxWords + x / 64] |= 1ULL << (x % 64);
+    }
+
+    uint64_t hash = counterrng::at(boxWidth, boxHeight);
+    for (size_t i = 0; i < words.size(); ++i) {
+        hash ^= Grid::hashWord(i, words[i]);
+    }
+    return hash;
+}
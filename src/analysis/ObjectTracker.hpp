@@ -0,0 +1,110 @@
+#ifndef OBJECTTRACKER_HPP
+#define OBJECTTRACKER_HPP
+
+#include "SoupSearch.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Grid;
+
+struct TrackedObject {
+    uint64_t id = 0;
+    unsigned int x = 0;            // Bounding box in the latest observed generation
+    unsigned int y = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int population = 0;
+    ObjectKind kind = ObjectKind::Unclassified;
+    unsigned int period = 0;       // 0 until the object has been seen to repeat
+    int dx = 0;                    // Displacement per period
+    int dy = 0;
+    uint64_t stableSince = 0;      // First generation of the current cycle
+
+    // Speed in Life notation, e.g. "c/4 diagonal" or "c/2 orthogonal"
+    std::string getSpeed() const;
+};
+
+// Follows objects across generations to tell spaceships from oscillators and
+// debris. Each object is hashed relative to its bounding box (with
+// Grid::hashWord, the stepper's word hash), and a track that sees the same
+// hash again p generations later has period p and moved by the offset of
+// its box.
+//
+// Only the tracks whose boxes cover a cell the grid reports as changed, and
+// objects grown from cells born since, are re-examined; the rest are not
+// looked at, so a generation costs time proportional to the objects that
+// changed. An object left untouched for a generation is a still life.
+class ObjectTracker {
+public:
+    explicit ObjectTracker(unsigned int maxPeriod = 64);
+
+    // Call after every generation or edit, before Grid::clearChanges(). The
+    // first call (and the first after reset) scans the whole grid.
+    void observe(const Grid& grid);
+    void reset();
+    // Drops a track, e.g. for an object about to be erased from the grid
+    void forget(uint64_t id);
+    // Follows the grid into a larger universe in which old cell (x, y) is at
+    // (x + offsetX, y + offsetY), keeping every track and its history
+    void rebase(unsigned int offsetX, unsigned int offsetY, unsigned int newWidth, unsigned int newHeight);
+
+    std::vector<TrackedObject> getObjects() const;
+    size_t getTrackCount() const { return tracks.size(); }
+    // Last generation in which an object died (rather than merging into a
+    // neighbour); forgotten tracks do not count
+    uint64_t getLastVanished() const { return lastVanished; }
+
+private:
+    struct Phase {
+        uint64_t generation;
+        uint64_t hash;
+        unsigned int x;
+        unsigned int y;
+        bool cyclic;   // Part of a still life or oscillator cycle
+    };
+
+    struct Track {
+        TrackedObject object;
+        std::deque<Phase> history;   // Phases within maxPeriod generations
+        uint64_t lastChanged = 0;
+        // Last still life or oscillator cycle, remembered through interruptions
+        unsigned int cyclePeriod = 0;
+        uint64_t cycleSince = 0;
+        // Neighbours that merged into this object, revived if they split off
+        std::vector<Track> absorbed;
+    };
+
+    struct Component {
+        std::vector<std::pair<unsigned int, unsigned int>> cells;
+        unsigned int minX;
+        unsigned int minY;
+        unsigned int maxX;
+        unsigned int maxY;
+    };
+
+    unsigned int maxPeriod;
+    bool primed;
+    unsigned int width;
+    unsigned int height;
+    uint64_t generation;
+    uint64_t nextId;
+    uint64_t lastVanished;
+
+    std::unordered_map<uint64_t, Track> tracks;
+    // Spatial index: tracks whose bounding box covers each BUCKET_SIZE square
+    std::unordered_map<uint64_t, std::vector<uint64_t>> buckets;
+    // Cells already assigned to a component this observation (Grid bit layout)
+    std::vector<uint64_t> visited;
+
+    void indexTrack(const Track& track, bool add);
+    void collectTracks(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,
+                       std::vector<uint64_t>& found) const;
+    Component extractComponent(const Grid& grid, unsigned int x, unsigned int y);
+    static uint64_t hashComponent(const Component& component);
+};
+
+#endif // OBJECTTRACKER_HPP
@@ -0,0 +1,183 @@
+#include "RuleSweep.hpp"
+#include "WorkStealingPool.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/CounterRng.hpp"
+#include "../core/LaneGrid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+// Per-thread state; rulesDone is read by the progress reporter
+struct alignas(64) RuleSweep::Worker {
+    Worker(unsigned int arenaSize)
+        : grid(arenaSize, arenaSize),
+          reference(arenaSize, arenaSize) {
+    }
+
+    LaneGrid grid;
+    LaneGrid reference;   // Checkpoint the lanes are compared against
+    std::atomic<uint64_t> rulesDone{0};
+};
+
+RuleSweep::RuleSweep(const RuleSweepConfig& config)
+    : config(config),
+      soupStride(0) {
+    this->config.firstRule = std::min(this->config.firstRule, LifeRule::RULE_COUNT);
+    this->config.ruleCount = std::min(this->config.ruleCount, LifeRule::RULE_COUNT - this->config.firstRule);
+    this->config.soupSize = std::min(std::max(this->config.soupSize, 1u), 64u);
+    this->config.arenaSize = std::max(this->config.arenaSize, this->config.soupSize);
+    this->config.maxPeriod = std::max(this->config.maxPeriod, 1u);
+
+    // Every rule sees the same soup: one counter-based word per row, centred
+    const unsigned int size = this->config.arenaSize;
+    const unsigned int soupSize = this->config.soupSize;
+    const unsigned int origin = (size - soupSize) / 2;
+    const uint32_t threshold = counterrng::densityThreshold(this->config.density);
+    soupStride = (size + 63) / 64;
+    soupRows.assign(static_cast<size_t>(soupStride) * size, 0);
+    for (unsigned int y = 0; y < soupSize; ++y) {
+        uint64_t bits = counterrng::bernoulliWord(this->config.seed, y, threshold) & bitops::lowMask(soupSize);
+        uint64_t* row = &soupRows[static_cast<size_t>(origin + y) * soupStride];
+        for (; bits; bits &= bits - 1) {
+            unsigned int x = origin + bitops::countTrailingZeros(bits);
+            row[x / 64] |= 1ULL << (x % 64);
+        }
+    }
+}
+
+RuleSweepResult RuleSweep::run(const ProgressCallback& progress) {
+    WorkStealingPool pool(config.threads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned int w = 0; w < pool.getThreadCount(); ++w) {
+        workers.push_back(std::make_unique<Worker>(config.arenaSize));
+    }
+
+    RuleSweepResult result;
+    result.rules.resize(config.ruleCount);
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double lastReport = 0.0;
+
+    // Each batch writes its own slice of the result, so no locking is needed
+    const uint64_t batches = (static_cast<uint64_t>(config.ruleCount) + LaneGrid::LANES - 1) / LaneGrid::LANES;
+    pool.run(batches, 1, [&](unsigned int w, uint64_t begin, uint64_t end) {
+        Worker& worker = *workers[w];
+        for (uint64_t batch = begin; batch < end; ++batch) {
+            uint32_t offset = static_cast<uint32_t>(batch * LaneGrid::LANES);
+            unsigned int lanes = std::min<unsigned int>(LaneGrid::LANES, config.ruleCount - offset);
+            runBatch(config.firstRule + offset, lanes, worker, &result.rules[offset]);
+            worker.rulesDone.fetch_add(lanes, std::memory_order_relaxed);
+        }
+
+        if (w == 0 && progress && elapsed() - lastReport >= 1.0) {
+            lastReport = elapsed();
+            uint64_t done = 0;
+            for (const auto& other : workers) {
+                done += other->rulesDone.load(std::memory_order_relaxed);
+            }
+            progress(done, lastReport);
+        }
+    });
+
+    result.seconds = elapsed();
+    result.rulesPerSecond = result.seconds > 0.0 ? result.rules.size() / result.seconds : 0.0;
+    return result;
+}
+
+void RuleSweep::runBatch(uint32_t firstRule, unsigned int lanes, Worker& worker, RuleStats* stats) const {
+    LaneGrid& grid = worker.grid;
+    LifeRule empty;
+    empty.birth = 0;
+    empty.survival = 0;
+    for (unsigned int lane = 0; lane < LaneGrid::LANES; ++lane) {
+        // Spare lanes of the last batch die at once and are never reported
+        grid.setRule(lane, lane < lanes ? LifeRule::fromIndex(firstRule + lane) : empty);
+    }
+    grid.loadAll(soupRows.data(), soupStride, config.arenaSize, config.arenaSize);
+    grid.setGeneration(0);
+
+    // A lane has settled when it matches the checkpoint taken up to maxPeriod
+    // generations earlier; the first match gives its period
+    unsigned int periods[LaneGrid::LANES] = {};
+    uint64_t settled[LaneGrid::LANES] = {};
+    uint64_t pending = lanes < LaneGrid::LANES ? bitops::lowMask(lanes) : ~0ULL;
+    uint64_t edge = 0;
+    worker.reference = grid;
+    uint64_t checkpoint = 0;
+
+    for (uint64_t generation = 1; generation <= config.maxGenerations && pending; ++generation) {
+        grid.nextGeneration();
+        edge |= grid.getEdgeLanes();
+
+        for (uint64_t repeated = pending & ~grid.getDifferingLanes(worker.reference); repeated;
+             repeated &= repeated - 1) {
+            unsigned int lane = bitops::countTrailingZeros(repeated);
+            periods[lane] = static_cast<unsigned int>(generation - checkpoint);
+            settled[lane] = checkpoint;
+            pending &= ~(1ULL << lane);
+        }
+
+        if (generation % config.maxPeriod == 0) {
+            worker.reference = grid;
+            checkpoint = generation;
+        }
+    }
+
+    const double area = static_cast<double>(config.arenaSize) * config.arenaSize;
+    const std::array<uint64_t, LaneGrid::LANES> populations = grid.getPopulations();
+    for (unsigned int lane = 0; lane < lanes; ++lane) {
+        RuleStats& out = stats[lane];
+        out.rule = grid.getRule(lane);
+        out.density = populations[lane] / area;
+        out.period = periods[lane];
+        out.settleGeneration = settled[lane];
+        if (periods[lane] == 0) {
+            out.growthClass = ((edge >> lane) & 1ULL) ? GrowthClass::Expanding : GrowthClass::Chaotic;
+        } else if (populations[lane] == 0) {
+            out.growthClass = GrowthClass::Dies;
+        } else {
+            out.growthClass = periods[lane] == 1 ? GrowthClass::Stable : GrowthClass::Oscillating;
+        }
+    }
+}
+
+bool RuleSweep::writeCsv(const RuleSweepResult& result, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file) {
+        error = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    file << "rule,final_density,period,settle_generation,class\n";
+    for (const RuleStats& stats : result.rules) {
+        file << stats.rule.toString() << ',' << stats.density << ',' << stats.period << ','
+             << stats.settleGeneration << ',' << getClassName(stats.growthClass) << '\n';
+    }
+
+    file.flush();
+    if (!file) {
+        error = "Failed writing " + filename;
+        return false;
+    }
+    return true;
+}
+
+const char* RuleSweep::getClassName(GrowthClass growthClass) {
+    switch (growthClass) {
+        case GrowthClass::Dies:
+            return "dies";
+        case GrowthClass::Stable:
+            return "stable";
+        case GrowthClass::Oscillating:
+            return "oscillating";
+        case GrowthClass::Expanding:
+            return "expanding";
+        default:
+            return "chaotic";
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef RULESWEEP_HPP
+#define RULESWEEP_HPP
+
+#include "../core/LifeRule.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct RuleSweepConfig {
+    uint32_t firstRule = 0;                       // LifeRule index of the first rule
+    uint32_t ruleCount = LifeRule::RULE_COUNT;    // Every Life-like rule by default
+    uint64_t seed = 0;
+    unsigned int threads = 0;                     // 0 = one per core
+    unsigned int soupSize = 16;                   // Side of the random square, at most 64
+    unsigned int arenaSize = 64;                  // Side of the bounded universe
+    unsigned int maxGenerations = 512;
+    unsigned int maxPeriod = 32;                  // Longest period recognised when settling
+    float density = 0.5f;
+};
+
+// How the soup behaved under a rule
+enum class GrowthClass {
+    Dies,          // No live cells left
+    Stable,        // Settled into still lifes
+    Oscillating,   // Settled with period > 1
+    Chaotic,       // Still changing, inside the universe
+    Expanding      // Still changing and reached the edge of the universe
+};
+
+struct RuleStats {
+    LifeRule rule;
+    double density = 0.0;                // Live fraction of the universe at the end
+    unsigned int period = 0;             // 0 if it never settled
+    uint64_t settleGeneration = 0;       // First checkpoint found on the final cycle
+    GrowthClass growthClass = GrowthClass::Chaotic;
+};
+
+struct RuleSweepResult {
+    std::vector<RuleStats> rules;        // In rule index order
+    double seconds = 0.0;
+    double rulesPerSecond = 0.0;
+};
+
+// Headless rule-space sweep: runs one seeded soup under a range of
+// Life-like rules and summarises how each behaves. Rules go through a
+// LaneGrid 64 at a time, one rule per lane, so a single pass of the
+// bit-sliced kernel advances 64 rules.
+//
+// A lane has settled once its whole universe repeats. Universes are bounded
+// like every other engine here, so B0 rules (which light the infinite
+// background) are simulated with a permanently dead outside.
+class RuleSweep {
+public:
+    using ProgressCallback = std::function<void(uint64_t rulesDone, double seconds)>;
+
+    explicit RuleSweep(const RuleSweepConfig& config);
+
+    // Runs the whole sweep. The progress callback, if any, is called about
+    // once a second from one of the workers.
+    RuleSweepResult run(const ProgressCallback& progress = nullptr);
+
+    // One line per rule: rule, final_density, period, settle_generation, class
+    bool writeCsv(const RuleSweepResult& result, const std::string& filename);
+    const std::string& getError() const { return error; }
+
+    static const char* getClassName(GrowthClass growthClass);
+
+private:
+    struct Worker;
+
+    RuleSweepConfig config;
+    std::vector<uint64_t> soupRows;   // The soup centred in the arena, Grid bit layout
+    unsigned int soupStride;
+    std::string error;
+
+    void runBatch(uint32_t firstRule, unsigned int lanes, Worker& worker, RuleStats* stats) const;
+};
+
+#endif // RULESWEEP_HPP
@@ -0,0 +1,432 @@
+#include "SoupSearch.hpp"
+#include "Census.hpp"
+#include "WorkStealingPool.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/CounterRng.hpp"
+#include "../core/Grid.hpp"
+#include "../core/LaneGrid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+// Once this few soups of a batch are still running, the rest finish in a
+// packed Grid, which no longer pays for the lanes that have settled
+constexpr unsigned int STRAGGLER_LANES = 8;
+// Soups stay in lanes while they fit a central window this wide. A lane word
+// holds one cell of each soup where a Grid word holds 64 cells of one, and
+// the lanes step the union of all 64 soups, so they only pay off while that
+// union is small.
+constexpr unsigned int LANE_WINDOW = 128;
+// Objects within this many cells of the arena edge are checked for escape
+constexpr unsigned int ESCAPE_MARGIN = 12;
+// A glider crosses a third of the margin between two checks
+constexpr unsigned int ESCAPE_CHECK_INTERVAL = 16;
+
+// One generation of an object: live cells relative to its bounding box, in
+// row-major order, so two phases compare equal whatever their position
+struct Phase {
+    std::vector<std::pair<int, int>> cells;
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+};
+
+Phase capturePhase(const Grid& grid) {
+    Phase phase;
+    phase.left = static_cast<int>(grid.getWidth());
+    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+        const uint64_t* row = grid.getRow(y);
+        for (unsigned int i = 0; i < grid.getWordsPerRow(); ++i) {
+            for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                int x = static_cast<int>(i * 64 + bitops::countTrailingZeros(bits));
+                phase.cells.emplace_back(x, static_cast<int>(y));
+                phase.left = std::min(phase.left, x);
+                phase.right = std::max(phase.right, x);
+            }
+        }
+    }
+    if (phase.cells.empty()) return phase;
+
+    phase.top = phase.cells.front().second;
+    phase.bottom = phase.cells.back().second;
+    for (auto& cell : phase.cells) {
+        cell.first -= phase.left;
+        cell.second -= phase.top;
+    }
+    return phase;
+}
+
+} // namespace
+
+std::string ObjectClass::getCode() const {
+    std::string code;
+    switch (kind) {
+        case ObjectKind::StillLife:
+            code = "xs" + std::to_string(population);
+            break;
+        case ObjectKind::Oscillator:
+            code = "xp" + std::to_string(period);
+            break;
+        case ObjectKind::Spaceship:
+            code = "xq" + std::to_string(period);
+            break;
+        default:
+            code = "other";
+            break;
+    }
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "_%08x", static_cast<unsigned int>(shape));
+    return code + suffix;
+}
+
+// Per-thread state. Counts are only written by the owning worker and merged
+// after the pool finishes; soupsDone is read by the progress reporter.
+struct alignas(64) SoupSearch::Worker {
+    Worker(unsigned int arenaSize)
+        : lanes(arenaSize, arenaSize),
+          reference(arenaSize, arenaSize),
+          arena(arenaSize, arenaSize),
+          visited(static_cast<size_t>(arenaSize) * arenaSize, 0),
+          history() {
+    }
+
+    LaneGrid lanes;
+    LaneGrid reference;   // Checkpoint the lanes are compared against
+    Grid arena;
+    std::vector<uint8_t> visited;
+    std::vector<uint64_t> history;
+    SoupSearchResult counts;
+    std::atomic<uint64_t> soupsDone{0};
+};
+
+SoupSearch::SoupSearch(const SoupSearchConfig& config)
+    : config(config) {
+    this->config.soupSize = std::min(std::max(this->config.soupSize, 1u), 64u);
+    this->config.arenaSize = std::max(this->config.arenaSize, this->config.soupSize + 4 * ESCAPE_MARGIN);
+    this->config.maxPeriod = std::max(this->config.maxPeriod, 1u);
+}
+
+SoupSearchResult SoupSearch::run(const ProgressCallback& progress) {
+    WorkStealingPool pool(config.threads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned int w = 0; w < pool.getThreadCount(); ++w) {
+        workers.push_back(std::make_unique<Worker>(config.arenaSize));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double lastReport = 0.0;
+
+    // Soups run 64 to a batch, one per lane; batch b always holds soups
+    // [64b, 64b + 64), so results do not depend on the thread count
+    const uint64_t batches = (config.soupCount + LaneGrid::LANES - 1) / LaneGrid::LANES;
+    pool.run(batches, 1, [&](unsigned int w, uint64_t begin, uint64_t end) {
+        Worker& worker = *workers[w];
+        for (uint64_t batch = begin; batch < end; ++batch) {
+            uint64_t first = batch * LaneGrid::LANES;
+            runBatch(first, static_cast<unsigned int>(std::min<uint64_t>(LaneGrid::LANES, config.soupCount - first)),
+                     worker);
+        }
+
+        if (w == 0 && progress && elapsed() - lastReport >= 1.0) {
+            lastReport = elapsed();
+            uint64_t done = 0;
+            for (const auto& other : workers) {
+                done += other->soupsDone.load(std::memory_order_relaxed);
+            }
+            progress(done, lastReport);
+        }
+    });
+
+    SoupSearchResult result;
+    for (const auto& worker : workers) {
+        const SoupSearchResult& counts = worker->counts;
+        result.soups += counts.soups;
+        result.unsettled += counts.unsettled;
+        result.generations += counts.generations;
+        result.stillLifes += counts.stillLifes;
+        result.oscillators += counts.oscillators;
+        result.spaceships += counts.spaceships;
+        result.unclassified += counts.unclassified;
+        for (const auto& entry : counts.objectCounts) {
+            result.objectCounts[entry.first] += entry.second;
+        }
+    }
+    result.seconds = elapsed();
+    result.soupsPerSecond = result.seconds > 0.0 ? result.soups / result.seconds : 0.0;
+    return result;
+}
+
+void SoupSearch::runBatch(uint64_t firstSoup, unsigned int count, Worker& worker) const {
+    LaneGrid& lanes = worker.lanes;
+    lanes.clear();
+    lanes.setGeneration(0);
+
+    // Each soup row is one counter-based word keyed on the soup index
+    const uint32_t threshold = counterrng::densityThreshold(config.density);
+    const unsigned int origin = (config.arenaSize - config.soupSize) / 2;
+    for (unsigned int lane = 0; lane < count; ++lane) {
+        const uint64_t index = firstSoup + lane;
+        for (unsigned int y = 0; y < config.soupSize; ++y) {
+            uint64_t bits = counterrng::bernoulliWord(config.seed, index * 64 + y, threshold) &
+                            bitops::lowMask(config.soupSize);
+            for (; bits; bits &= bits - 1) {
+                lanes.setCell(lane, origin + bitops::countTrailingZeros(bits), origin + y, true);
+            }
+        }
+    }
+    worker.counts.soups += count;
+
+    // A soup that leaves the window finishes in the packed arena from the
+    // same generation, where spaceships nearing the edge can be removed. The
+    // window lies inside the escape margin, so until then escape checks
+    // would have found nothing and the outcome is the one the arena gives.
+    Grid& arena = worker.arena;
+    const unsigned int window = std::min(config.arenaSize, LANE_WINDOW);
+    const unsigned int laneMargin = std::max(ESCAPE_MARGIN, (config.arenaSize - window) / 2);
+    auto finish = [&](unsigned int lane, uint64_t generation) {
+        lanes.storeLane(lane, arena);
+        lanes.clearLane(lane);
+        arena.setGeneration(generation);
+        settleArena(static_cast<unsigned int>(generation), worker);
+        worker.soupsDone.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // A lane has settled when it matches the checkpoint taken up to maxPeriod
+    // generations earlier, as in a rule sweep. This notices a settled soup up
+    // to two periods later than the arena's hash history would, at a cost of
+    // one comparison per generation for all 64 soups.
+    uint64_t pending = bitops::lowMask(count);
+    worker.reference = lanes;
+    for (uint64_t generation = 0; pending; ++generation) {
+        if (generation == config.maxGenerations) {
+            const unsigned int unsettled = static_cast<unsigned int>(bitops::popcount(pending));
+            worker.counts.generations += static_cast<uint64_t>(unsettled) * config.maxGenerations;
+            worker.counts.unsettled += unsettled;
+            worker.soupsDone.fetch_add(unsettled, std::memory_order_relaxed);
+            break;
+        }
+
+        if (generation % ESCAPE_CHECK_INTERVAL == 0) {
+            uint64_t handoff = lanes.getEdgeLanes(laneMargin) & pending;
+            if (bitops::popcount(pending) <= static_cast<int>(STRAGGLER_LANES)) {
+                handoff = pending;
+            }
+            for (; handoff; handoff &= handoff - 1) {
+                unsigned int lane = bitops::countTrailingZeros(handoff);
+                pending &= ~(1ULL << lane);
+                finish(lane, generation);
+            }
+            if (!pending) break;
+        }
+
+        if (generation > 0) {
+            for (uint64_t settled = pending & ~lanes.getDifferingLanes(worker.reference); settled;
+                 settled &= settled - 1) {
+                unsigned int lane = bitops::countTrailingZeros(settled);
+                pending &= ~(1ULL << lane);
+                worker.counts.generations += generation;
+                lanes.storeLane(lane, arena);
+                lanes.clearLane(lane);
+                censusArena(worker);
+                worker.soupsDone.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (generation % config.maxPeriod == 0) {
+            worker.reference = lanes;
+        }
+        lanes.nextGeneration();
+    }
+}
+
+void SoupSearch::settleArena(unsigned int start, Worker& worker) const {
+    // The soup has settled once the whole arena repeats; spaceships are
+    // removed as they approach the edge so they cannot prevent that
+    Grid& arena = worker.arena;
+    const unsigned int maxPeriod = config.maxPeriod;
+    worker.history.assign(maxPeriod, 0);
+
+    for (unsigned int generation = start; generation < config.maxGenerations; ++generation) {
+        if (generation % ESCAPE_CHECK_INTERVAL == 0) {
+            removeEscapees(worker);
+        }
+
+        uint64_t hash = arena.getHash(); // Kept up to date by the stepper
+        for (unsigned int p = 1; p <= std::min(generation - start, maxPeriod); ++p) {
+            if (worker.history[(generation - p) % maxPeriod] == hash) {
+                worker.counts.generations += generation;
+                censusArena(worker);
+                return;
+            }
+        }
+        worker.history[generation % maxPeriod] = hash;
+        arena.nextGeneration();
+    }
+
+    worker.counts.generations += config.maxGenerations;
+    ++worker.counts.unsettled;
+}
+
+void SoupSearch::removeEscapees(Worker& worker) const {
+    Grid& arena = worker.arena;
+    const unsigned int size = config.arenaSize;
+    std::vector<std::pair<int, int>> seen;
+
+    auto check = [&](unsigned int x, unsigned int y) {
+        if (!arena.getCell(x, y) || worker.visited[static_cast<size_t>(y) * size + x]) return;
+        auto cluster = extractCluster(arena, x, y, worker.visited);
+        ObjectClass object = classifyObject(cluster, config.maxPeriod);
+        if (object.kind == ObjectKind::Spaceship) {
+            tallyObject(object, worker);
+            std::vector<std::pair<unsigned int, unsigned int>> positions(cluster.begin(), cluster.end());
+            arena.setCells(positions, false);
+        }
+        seen.insert(seen.end(), cluster.begin(), cluster.end());
+    };
+
+    for (unsigned int y = 0; y < size; ++y) {
+        const uint64_t* row = arena.getRow(y);
+        bool edgeRow = y < ESCAPE_MARGIN || y >= size - ESCAPE_MARGIN;
+        for (unsigned int i = 0; i < arena.getWordsPerRow(); ++i) {
+            for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                unsigned int x = i * 64 + bitops::countTrailingZeros(bits);
+                if (edgeRow || x < ESCAPE_MARGIN || x >= size - ESCAPE_MARGIN) {
+                    check(x, y);
+                }
+            }
+        }
+    }
+
+    for (const auto& cell : seen) {
+        worker.visited[static_cast<size_t>(cell.second) * size + cell.first] = 0;
+    }
+}
+
+void SoupSearch::censusArena(Worker& worker) const {
+    Grid& arena = worker.arena;
+    const unsigned int size = config.arenaSize;
+    std::vector<std::pair<int, int>> seen;
+
+    for (unsigned int y = 0; y < size; ++y) {
+        const uint64_t* row = arena.getRow(y);
+        for (unsigned int i = 0; i < arena.getWordsPerRow(); ++i) {
+            for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                unsigned int x = i * 64 + bitops::countTrailingZeros(bits);
+                if (worker.visited[static_cast<size_t>(y) * size + x]) continue;
+                auto cluster = extractCluster(arena, x, y, worker.visited);
+                tallyObject(classifyObject(cluster, config.maxPeriod), worker);
+                seen.insert(seen.end(), cluster.begin(), cluster.end());
+            }
+        }
+    }
+
+    for (const auto& cell : seen) {
+        worker.visited[static_cast<size_t>(cell.second) * size + cell.first] = 0;
+    }
+}
+
+void SoupSearch::tallyObject(const ObjectClass& object, Worker& worker) const {
+    SoupSearchResult& counts = worker.counts;
+    switch (object.kind) {
+        case ObjectKind::StillLife:  ++counts.stillLifes; break;
+        case ObjectKind::Oscillator: ++counts.oscillators; break;
+        case ObjectKind::Spaceship:  ++counts.spaceships; break;
+        default:                     ++counts.unclassified; break;
+    }
+    ++counts.objectCounts[object.getCode()];
+}
+
+std::vector<std::pair<int, int>> SoupSearch::extractCluster(const Grid& grid, unsigned int x, unsigned int y,
+                                                            std::vector<uint8_t>& visited) {
+    // Cells up to two apart can influence a common neighbour, so they are
+    // grouped into one object
+    const int width = static_cast<int>(grid.getWidth());
+    const int height = static_cast<int>(grid.getHeight());
+    std::vector<std::pair<int, int>> cluster;
+    std::vector<std::pair<int, int>> stack{{static_cast<int>(x), static_cast<int>(y)}};
+    visited[static_cast<size_t>(y) * width + x] = 1;
+
+    while (!stack.empty()) {
+        auto cell = stack.back();
+        stack.pop_back();
+        cluster.push_back(cell);
+
+        for (int dy = -2; dy <= 2; ++dy) {
+            for (int dx = -2; dx <= 2; ++dx) {
+                int nx = cell.first + dx;
+                int ny = cell.second + dy;
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                uint8_t& mark = visited[static_cast<size_t>(ny) * width + nx];
+                if (mark || !grid.getCell(nx, ny)) continue;
+                mark = 1;
+                stack.emplace_back(nx, ny);
+            }
+        }
+    }
+    return cluster;
+}
+
+ObjectClass SoupSearch::classifyObject(const std::vector<std::pair<int, int>>& cells, unsigned int maxPeriod) {
+    ObjectClass result;
+    result.population = static_cast<unsigned int>(cells.size());
+    if (cells.empty()) return result;
+
+    int minX = cells.front().first;
+    int maxX = minX;
+    int minY = cells.front().second;
+    int maxY = minY;
+    for (const auto& cell : cells) {
+        minX = std::min(minX, cell.first);
+        maxX = std::max(maxX, cell.first);
+        minY = std::min(minY, cell.second);
+        maxY = std::max(maxY, cell.second);
+    }
+
+    // Room for a c/2 ship to travel a full period without reaching the edge
+    const int pad = static_cast<int>(maxPeriod / 2) + 2;
+    const int width = maxX - minX + 1 + 2 * pad;
+    const int height = maxY - minY + 1 + 2 * pad;
+    Grid grid(width, height);
+    for (const auto& cell : cells) {
+        grid.setCell(cell.first - minX + pad, cell.second - minY + pad, true);
+    }
+
+    const Phase initial = capturePhase(grid);
+    // A periodic object is keyed on its smallest phase hash, so it gets the
+    // same shape whichever phase it was found in
+    uint64_t shape = Census::canonicalHash(initial.cells);
+    result.shape = shape;
+
+    for (unsigned int period = 1; period <= maxPeriod; ++period) {
+        grid.nextGeneration();
+        Phase phase = capturePhase(grid);
+        if (phase.cells.empty()) break; // Dies on its own
+        if (phase.left == 0 || phase.top == 0 || phase.right == width - 1 || phase.bottom == height - 1) {
+            break; // Outgrew the pad, so it is not a finite periodic object
+        }
+        if (phase.cells != initial.cells) {
+            shape = std::min(shape, Census::canonicalHash(phase.cells));
+            continue;
+        }
+
+        result.period = period;
+        result.shape = shape;
+        result.dx = phase.left - initial.left;
+        result.dy = phase.top - initial.top;
+        if (result.dx != 0 || result.dy != 0) {
+            result.kind = ObjectKind::Spaceship;
+        } else {
+            result.kind = period == 1 ? ObjectKind::StillLife : ObjectKind::Oscillator;
+        }
+        break;
+    }
+    return result;
+}
@@ -0,0 +1,95 @@
+#ifndef SOUPSEARCH_HPP
+#define SOUPSEARCH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Grid;
+
+struct SoupSearchConfig {
+    uint64_t soupCount = 10000;
+    uint64_t seed = 0;
+    unsigned int threads = 0;          // 0 = one per core
+    unsigned int soupSize = 16;        // Side of the random square, at most 64
+    unsigned int arenaSize = 256;      // Side of the bounded universe each soup runs in
+    unsigned int maxGenerations = 30000;
+    unsigned int maxPeriod = 64;       // Longest period recognised when settling
+    float density = 0.5f;
+};
+
+// How an object behaves when stepped on its own
+enum class ObjectKind {
+    StillLife,
+    Oscillator,
+    Spaceship,
+    Unclassified   // No period up to the limit, or not a single object
+};
+
+struct ObjectClass {
+    ObjectKind kind = ObjectKind::Unclassified;
+    unsigned int population = 0;
+    unsigned int period = 0;
+    int dx = 0;
+    int dy = 0;
+    uint64_t shape = 0;   // Smallest Census::canonicalHash over its phases
+
+    // Census code: xs<population> for still lifes, xp<period> for
+    // oscillators, xq<period> for spaceships and "other" otherwise, then the
+    // shape, e.g. xs4_1a2b3c4d, so a block and a tub are counted apart
+    std::string getCode() const;
+};
+
+struct SoupSearchResult {
+    uint64_t soups = 0;
+    uint64_t unsettled = 0;        // Still changing after maxGenerations
+    uint64_t generations = 0;
+    uint64_t stillLifes = 0;
+    uint64_t oscillators = 0;
+    uint64_t spaceships = 0;
+    uint64_t unclassified = 0;
+    std::map<std::string, uint64_t> objectCounts;
+    double seconds = 0.0;
+    double soupsPerSecond = 0.0;
+};
+
+// Headless statistical search: evolves many seeded random soups until each
+// settles and counts the objects left behind. Soup i is a pure function of
+// (seed, i), so a search is reproducible whatever the thread count.
+//
+// Soups run 64 at a time in the lanes of a LaneGrid while they stay clear of
+// the arena edge; a soup that nears it, and the last few of a batch, finish
+// one at a time in a packed Grid where escaping spaceships can be removed.
+class SoupSearch {
+public:
+    using ProgressCallback = std::function<void(uint64_t soupsDone, double seconds)>;
+
+    explicit SoupSearch(const SoupSearchConfig& config);
+
+    // Runs the whole search. The progress callback, if any, is called about
+    // once a second from one of the workers.
+    SoupSearchResult run(const ProgressCallback& progress = nullptr);
+
+    // Steps one object in isolation and reports its period and displacement
+    static ObjectClass classifyObject(const std::vector<std::pair<int, int>>& cells, unsigned int maxPeriod);
+
+private:
+    struct Worker;
+
+    SoupSearchConfig config;
+
+    // Runs soups [firstSoup, firstSoup + count) in the lanes of one LaneGrid
+    void runBatch(uint64_t firstSoup, unsigned int count, Worker& worker) const;
+    // Finishes the soup in the worker's arena, which is at generation `start`
+    void settleArena(unsigned int start, Worker& worker) const;
+    void removeEscapees(Worker& worker) const;
+    void censusArena(Worker& worker) const;
+    void tallyObject(const ObjectClass& object, Worker& worker) const;
+    static std::vector<std::pair<int, int>> extractCluster(const Grid& grid, unsigned int x, unsigned int y,
+                                                           std::vector<uint8_t>& visited);
+};
+
+#endif // SOUPSEARCH_HPP
@@ -0,0 +1,90 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Unclaimed part of one worker's slice. Padded to a cache line so workers
+// taking from their own slice do not contend with each other.
+struct alignas(64) Slice {
+    std::mutex mutex;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+};
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned int threads)
+    : threadCount(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+void WorkStealingPool::run(uint64_t count, uint64_t grain, const Task& task) {
+    if (count == 0) return;
+    grain = std::max<uint64_t>(grain, 1);
+
+    const unsigned int workers = static_cast<unsigned int>(
+        std::min<uint64_t>(threadCount, (count + grain - 1) / grain));
+    std::unique_ptr<Slice[]> slices(new Slice[workers]);
+    for (unsigned int w = 0; w < workers; ++w) {
+        slices[w].begin = count * w / workers;
+        slices[w].end = count * (w + 1) / workers;
+    }
+
+    auto takeOwn = [&](unsigned int w, uint64_t& begin, uint64_t& end) {
+        Slice& slice = slices[w];
+        std::lock_guard<std::mutex> lock(slice.mutex);
+        if (slice.begin >= slice.end) return false;
+        begin = slice.begin;
+        end = std::min(slice.end, begin + grain);
+        slice.begin = end;
+        return true;
+    };
+
+    // Moves the back half of the first non-empty victim into the thief's
+    // slice. Work only ever moves between slices, so once every slice is
+    // empty the whole range has been claimed and the thief can stop.
+    auto steal = [&](unsigned int thief) {
+        for (unsigned int offset = 1; offset < workers; ++offset) {
+            Slice& victim = slices[(thief + offset) % workers];
+            uint64_t begin;
+            uint64_t end;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (victim.begin >= victim.end) continue;
+                end = victim.end;
+                begin = victim.begin + (victim.end - victim.begin) / 2;
+                victim.end = begin;
+            }
+            Slice& own = slices[thief];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+            return true;
+        }
+        return false;
+    };
+
+    auto worker = [&](unsigned int w) {
+        uint64_t begin;
+        uint64_t end;
+        while (true) {
+            if (takeOwn(w, begin, end)) {
+                task(w, begin, end);
+            } else if (!steal(w)) {
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int w = 1; w < workers; ++w) {
+        threads.emplace_back(worker, w);
+    }
+    worker(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <cstdint>
+#include <functional>
+
+// Runs a task over an index range on a set of threads. Each worker starts
+// with an equal slice and takes `grain` indices at a time from its front;
+// a worker that runs dry steals the back half of another worker's slice,
+// so uneven task costs (soups that settle fast or slowly) stay balanced.
+class WorkStealingPool {
+public:
+    // Called with the worker number (0..threads-1) and a half-open range
+    using Task = std::function<void(unsigned int worker, uint64_t begin, uint64_t end)>;
+
+    explicit WorkStealingPool(unsigned int threads = 0); // 0 = one per core
+
+    // Blocks until every index in [0, count) has been processed. Worker 0
+    // runs on the calling thread.
+    void run(uint64_t count, uint64_t grain, const Task& task);
+
+    unsigned int getThreadCount() const { return threadCount; }
+
+private:
+    unsigned int threadCount;
+};
+
+#endif // WORKSTEALINGPOOL_HPP
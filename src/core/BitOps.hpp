@@ -0,0 +1,55 @@
+#ifndef BITOPS_HPP
+#define BITOPS_HPP
+
+#include <cstdint>
+
+// Small wrappers around the compiler bit-scan intrinsics used by the packed grid code
+namespace bitops {
+
+inline int countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while (!(word & 1ULL)) {
+        word >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Index of the most significant set bit (word must be non-zero)
+inline int highestSetBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#else
+    int index = 0;
+    while (word >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+inline int popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    while (word) {
+        word &= word - 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Mask with the low `bits` bits set (bits in [0, 64])
+inline uint64_t lowMask(unsigned int bits) {
+    return bits >= 64 ? ~0ULL : ((1ULL << bits) - 1ULL);
+}
+
+} // namespace bitops
+
+#endif // BITOPS_HPP
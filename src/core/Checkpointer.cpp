@@ -0,0 +1,79 @@
+#include "Checkpointer.hpp"
+#include "SnapshotFile.hpp"
+#include <utility>
+
+Checkpointer::Checkpointer(const std::string& filename)
+    : filename(filename),
+      pending(),
+      hasPending(false),
+      writing(false),
+      stopping(false),
+      lastSavedGeneration(0) {
+    // Start the thread last, once every member it reads is initialized
+    worker = std::thread(&Checkpointer::writerLoop, this);
+}
+
+Checkpointer::~Checkpointer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    worker.join();
+}
+
+void Checkpointer::submit(Grid::Snapshot snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(snapshot);
+        hasPending = true;
+    }
+    wakeUp.notify_one();
+}
+
+bool Checkpointer::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writing || hasPending;
+}
+
+uint64_t Checkpointer::getLastSavedGeneration() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastSavedGeneration;
+}
+
+std::string Checkpointer::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+void Checkpointer::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        wakeUp.wait(lock, [this]() { return hasPending || stopping; });
+        if (!hasPending) {
+            break; // Stopping with nothing left to write
+        }
+
+        Grid::Snapshot snapshot = std::move(pending);
+        pending.tiles.clear();
+        hasPending = false;
+        writing = true;
+        lock.unlock();
+
+        SnapshotFile file;
+        bool saved = file.save(snapshot, filename);
+        uint64_t generation = snapshot.generation;
+        // Drop our references before reporting, so the grid can reuse the tiles
+        snapshot.tiles.clear();
+
+        lock.lock();
+        writing = false;
+        if (saved) {
+            lastSavedGeneration = generation;
+            lastError.clear();
+        } else {
+            lastError = file.getError();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef CHECKPOINTER_HPP
+#define CHECKPOINTER_HPP
+
+#include "Grid.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Writes grid snapshots to disk on a background thread. Snapshots share the
+// grid's buffer copy-on-write, so taking one is O(1) and the stepper never
+// waits on disk I/O. Each write is atomic (see SnapshotFile::save).
+class Checkpointer {
+public:
+    explicit Checkpointer(const std::string& filename);
+    ~Checkpointer(); // Finishes any pending write before returning
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    // Queues a snapshot for writing. If the writer is still busy, a snapshot
+    // that has not started yet is replaced by this newer one.
+    void submit(Grid::Snapshot snapshot);
+
+    bool isBusy() const;
+    const std::string& getFilename() const { return filename; }
+    uint64_t getLastSavedGeneration() const;
+    std::string getLastError() const;
+
+private:
+    std::string filename;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    Grid::Snapshot pending;
+    bool hasPending;
+    bool writing;
+    bool stopping;
+    uint64_t lastSavedGeneration;
+    std::string lastError;
+
+    std::thread worker;
+
+    void writerLoop();
+};
+
+#endif // CHECKPOINTER_HPP
@@ -0,0 +1,55 @@
+#ifndef COUNTERRNG_HPP
+#define COUNTERRNG_HPP
+
+#include <cstdint>
+
+// Counter-based random bits: every value is a pure function of (seed,
+// counter), so any word of a random fill can be generated independently and
+// in any order. The result does not depend on how work is split across
+// threads.
+namespace counterrng {
+
+// Number of fractional bits used to represent a density
+constexpr unsigned int DENSITY_BITS = 16;
+constexpr uint32_t DENSITY_ONE = 1u << DENSITY_BITS;
+
+// SplitMix64 finalizer over a Weyl sequence
+inline uint64_t at(uint64_t seed, uint64_t counter) {
+    uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Density in [0, 1] as a threshold out of DENSITY_ONE
+inline uint32_t densityThreshold(float density) {
+    if (!(density > 0.0f)) return 0;
+    if (density >= 1.0f) return DENSITY_ONE;
+    return static_cast<uint32_t>(density * static_cast<float>(DENSITY_ONE) + 0.5f);
+}
+
+// 64 independent bits, each set with probability threshold / DENSITY_ONE.
+// Walks the threshold's binary digits from the lowest set one upward:
+// OR-ing in a fair random word maps p to (1 + p) / 2 and AND-ing maps it
+// to p / 2, which leaves p equal to the threshold's binary fraction.
+inline uint64_t bernoulliWord(uint64_t seed, uint64_t counter, uint32_t threshold) {
+    if (threshold == 0) return 0;
+    if (threshold >= DENSITY_ONE) return ~0ULL;
+
+    uint64_t base = counter * DENSITY_BITS;
+    unsigned int bit = 0;
+    while (!((threshold >> bit) & 1u)) {
+        ++bit;
+    }
+
+    uint64_t result = 0;
+    for (; bit < DENSITY_BITS; ++bit) {
+        uint64_t random = at(seed, base + bit);
+        result = ((threshold >> bit) & 1u) ? (result | random) : (result & random);
+    }
+    return result;
+}
+
+} // namespace counterrng
+
+#endif // COUNTERRNG_HPP
@@ -0,0 +1,388 @@
+#include "DeltaLog.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (unsigned int shift = 0; cursor < end && shift < 64; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Encodes `words` as (zero run, literal count, literal words...) groups.
+// XOR against the previous frame is folded in, so keyframes pass no base.
+void encodeFrame(const uint64_t* words, const uint64_t* base, size_t count, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < count) {
+        size_t zeroStart = i;
+        while (i < count && (words[i] ^ (base ? base[i] : 0)) == 0) {
+            ++i;
+        }
+        if (i == count) break; // Trailing zeros are implied
+
+        size_t literalStart = i;
+        while (i < count && (words[i] ^ (base ? base[i] : 0)) != 0) {
+            ++i;
+        }
+
+        appendVarint(out, literalStart - zeroStart);
+        appendVarint(out, i - literalStart);
+        size_t at = out.size();
+        out.resize(at + (i - literalStart) * sizeof(uint64_t));
+        for (size_t j = literalStart; j < i; ++j, at += sizeof(uint64_t)) {
+            uint64_t word = words[j] ^ (base ? base[j] : 0);
+            std::memcpy(&out[at], &word, sizeof(uint64_t));
+        }
+    }
+}
+
+// XORs a decoded frame into `cells` (which must be zeroed first for a keyframe)
+bool decodeFrame(const std::vector<uint8_t>& in, uint64_t* cells, size_t count) {
+    const uint8_t* cursor = in.data();
+    const uint8_t* end = cursor + in.size();
+    size_t position = 0;
+
+    while (cursor < end) {
+        uint64_t zeros = 0;
+        uint64_t literals = 0;
+        if (!readVarint(cursor, end, zeros) || !readVarint(cursor, end, literals)) {
+            return false;
+        }
+        if (zeros > count - position || literals > count - position - zeros ||
+            literals > static_cast<uint64_t>(end - cursor) / sizeof(uint64_t)) {
+            return false;
+        }
+
+        position += zeros;
+        for (uint64_t j = 0; j < literals; ++j, ++position, cursor += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, cursor, sizeof(uint64_t));
+            cells[position] ^= word;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+DeltaLogWriter::DeltaLogWriter()
+    : keyframeInterval(DeltaLogFormat::DEFAULT_KEYFRAME_INTERVAL),
+      width(0), height(0),
+      lastGeneration(0),
+      stopping(false),
+      framesWritten(0),
+      bytesWritten(0) {
+}
+
+DeltaLogWriter::~DeltaLogWriter() {
+    close();
+}
+
+bool DeltaLogWriter::open(const std::string& filename, const Grid::Snapshot& first, uint32_t interval) {
+    close();
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    DeltaLogFormat::Header header{};
+    std::memcpy(header.magic, DeltaLogFormat::MAGIC, sizeof(header.magic));
+    header.version = DeltaLogFormat::VERSION;
+    header.headerSize = sizeof(DeltaLogFormat::Header);
+    header.width = first.width;
+    header.height = first.height;
+    header.wordsPerRow = first.wordsPerRow;
+    header.keyframeInterval = std::max<uint32_t>(interval, 1);
+    header.startGeneration = first.generation;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    keyframeInterval = header.keyframeInterval;
+    width = first.width;
+    height = first.height;
+    previous.assign(static_cast<size_t>(first.wordsPerRow) * first.height, 0);
+    queue.clear();
+    queue.push_back(first);
+    stopping = false;
+    framesWritten = 0;
+    bytesWritten = sizeof(header);
+    error.clear();
+
+    worker = std::thread(&DeltaLogWriter::writerLoop, this);
+    return true;
+}
+
+void DeltaLogWriter::close() {
+    if (!worker.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    worker.join();
+    file.close();
+}
+
+void DeltaLogWriter::record(Grid::Snapshot snapshot) {
+    if (!worker.joinable()) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    queueChanged.wait(lock, [this]() { return queue.size() < MAX_QUEUED; });
+    queue.push_back(std::move(snapshot));
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+std::string DeltaLogWriter::getError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+uint64_t DeltaLogWriter::getFramesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return framesWritten;
+}
+
+uint64_t DeltaLogWriter::getBytesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytesWritten;
+}
+
+void DeltaLogWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        queueChanged.wait(lock, [this]() { return !queue.empty() || stopping; });
+        if (queue.empty()) {
+            break; // Stopping and fully drained
+        }
+
+        Grid::Snapshot snapshot = std::move(queue.front());
+        queue.pop_front();
+        bool failed = !error.empty();
+        lock.unlock();
+        queueChanged.notify_all();
+
+        bool written = !failed && writeFrame(snapshot);
+        snapshot.tiles.clear(); // Let the grid reuse the tiles
+
+        lock.lock();
+        if (written) {
+            ++framesWritten;
+            bytesWritten += sizeof(DeltaLogFormat::FrameHeader) + payload.size();
+        } else if (!failed) {
+            error = "Failed writing delta log frame at generation " + std::to_string(snapshot.generation);
+        }
+    }
+
+    file.flush();
+}
+
+bool DeltaLogWriter::writeFrame(const Grid::Snapshot& snapshot) {
+    if (snapshot.width != width || snapshot.height != height) {
+        return false;
+    }
+
+    // Flatten the tiles so the frame is diffed as one row-major word array
+    const size_t count = previous.size();
+    current.resize(count);
+    for (size_t t = 0; t < snapshot.tiles.size(); ++t) {
+        size_t offset = t * Grid::TILE_ROWS * static_cast<size_t>(snapshot.wordsPerRow);
+        std::copy_n(snapshot.tiles[t].get(), static_cast<size_t>(snapshot.getTileRows(t)) * snapshot.wordsPerRow,
+                    current.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+    // Going back in time starts a new segment, which must open with a keyframe
+    bool keyframe = framesWritten % keyframeInterval == 0 ||
+                    (framesWritten > 0 && snapshot.generation <= lastGeneration);
+    lastGeneration = snapshot.generation;
+    encodeFrame(current.data(), keyframe ? nullptr : previous.data(), count, payload);
+    previous.swap(current);
+
+    DeltaLogFormat::FrameHeader frame{};
+    frame.generation = snapshot.generation;
+    frame.payloadSize = payload.size();
+    frame.type = keyframe ? DeltaLogFormat::FRAME_KEY : DeltaLogFormat::FRAME_DELTA;
+    file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    return static_cast<bool>(file);
+}
+
+bool DeltaLogReader::open(const std::string& filename) {
+    error.clear();
+    frames.clear();
+    segmentStarts.clear();
+    positioned = false;
+
+    file.close();
+    file.clear();
+    file.open(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, DeltaLogFormat::MAGIC, sizeof(header.magic)) != 0) {
+        error = filename + " is not a delta log";
+        return false;
+    }
+    if (header.version < 1 || header.version > DeltaLogFormat::VERSION || header.headerSize != sizeof(header) ||
+        header.wordsPerRow != (header.width + 63) / 64) {
+        error = "Unsupported delta log layout in " + filename;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+
+    // Index every complete frame by skipping over payloads
+    uint64_t offset = sizeof(header);
+    while (offset + sizeof(DeltaLogFormat::FrameHeader) <= fileSize) {
+        DeltaLogFormat::FrameHeader frame;
+        file.seekg(static_cast<std::streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(&frame), sizeof(frame))) break;
+
+        uint64_t payloadOffset = offset + sizeof(frame);
+        if (frame.payloadSize > fileSize - payloadOffset) break; // Truncated tail
+        if (frame.type != DeltaLogFormat::FRAME_KEY && frame.type != DeltaLogFormat::FRAME_DELTA) break;
+        if (frames.empty() && frame.type != DeltaLogFormat::FRAME_KEY) break;
+
+        // A keyframe that does not move forward opens a new segment; any other
+        // step back means the log is damaged
+        const bool keyframe = frame.type == DeltaLogFormat::FRAME_KEY;
+        if (frames.empty() || frame.generation <= frames.back().generation) {
+            if (!keyframe) {
+                error = "Non-monotonic generation " + std::to_string(frame.generation) + " at offset " +
+                        std::to_string(offset) + " in " + filename;
+                frames.clear();
+                segmentStarts.clear();
+                return false;
+            }
+            segmentStarts.push_back(frames.size());
+        }
+
+        frames.push_back({frame.generation, payloadOffset, frame.payloadSize, keyframe});
+        offset = payloadOffset + frame.payloadSize;
+    }
+    file.clear();
+
+    if (frames.empty()) {
+        error = filename + " holds no complete frames";
+        return false;
+    }
+
+    cells.assign(static_cast<size_t>(header.wordsPerRow) * header.height, 0);
+    return seek(frames.front().generation, 0);
+}
+
+uint64_t DeltaLogReader::getFirstGeneration() const {
+    uint64_t first = frames.empty() ? 0 : frames.front().generation;
+    for (size_t start : segmentStarts) {
+        first = std::min(first, frames[start].generation);
+    }
+    return first;
+}
+
+uint64_t DeltaLogReader::getLastGeneration() const {
+    uint64_t last = 0;
+    for (size_t segment = 0; segment < segmentStarts.size(); ++segment) {
+        last = std::max(last, frames[segmentEnd(segment) - 1].generation);
+    }
+    return last;
+}
+
+size_t DeltaLogReader::segmentEnd(size_t segment) const {
+    return segment + 1 < segmentStarts.size() ? segmentStarts[segment + 1] : frames.size();
+}
+
+bool DeltaLogReader::seek(uint64_t generation) {
+    // The latest segment that reaches the generation
+    for (size_t segment = segmentStarts.size(); segment-- > 0;) {
+        if (frames[segmentStarts[segment]].generation <= generation &&
+            generation <= frames[segmentEnd(segment) - 1].generation) {
+            return seek(generation, segment);
+        }
+    }
+    error = "Generation " + std::to_string(generation) + " is not in the log";
+    return false;
+}
+
+bool DeltaLogReader::seek(uint64_t generation, size_t segment) {
+    if (segment >= segmentStarts.size() || generation < frames[segmentStarts[segment]].generation ||
+        generation > frames[segmentEnd(segment) - 1].generation) {
+        error = "Generation " + std::to_string(generation) + " is not in the log";
+        return false;
+    }
+
+    // Last frame of the segment at or before the target generation
+    auto first = frames.begin() + static_cast<std::ptrdiff_t>(segmentStarts[segment]);
+    auto last = frames.begin() + static_cast<std::ptrdiff_t>(segmentEnd(segment));
+    auto it = std::upper_bound(first, last, generation,
+                               [](uint64_t value, const FrameEntry& entry) { return value < entry.generation; });
+    size_t target = static_cast<size_t>(it - frames.begin()) - 1;
+
+    size_t keyframe = target;
+    while (!frames[keyframe].keyframe) {
+        --keyframe;
+    }
+
+    // Decode forward from where we are if that is no further than the keyframe
+    size_t start = keyframe;
+    if (positioned && currentFrame >= keyframe && currentFrame <= target) {
+        start = currentFrame + 1;
+    }
+
+    for (size_t i = start; i <= target; ++i) {
+        if (!applyFrame(i)) {
+            positioned = false;
+            return false;
+        }
+    }
+
+    currentFrame = target;
+    currentSegment = segment;
+    currentGeneration = frames[target].generation;
+    positioned = true;
+    return true;
+}
+
+bool DeltaLogReader::applyFrame(size_t index) {
+    const FrameEntry& entry = frames[index];
+
+    payload.resize(static_cast<size_t>(entry.payloadSize));
+    file.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()))) {
+        file.clear();
+        error = "Failed reading frame at generation " + std::to_string(entry.generation);
+        return false;
+    }
+
+    if (entry.keyframe) {
+        std::fill(cells.begin(), cells.end(), 0);
+    }
+    if (!decodeFrame(payload, cells.data(), cells.size())) {
+        error = "Corrupt frame at generation " + std::to_string(entry.generation);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,158 @@
+#ifndef DELTALOG_HPP
+#define DELTALOG_HPP
+
+#include "Grid.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Append-only generation history. After a fixed header, every recorded
+// generation is one frame: a keyframe (the full grid) every `keyframeInterval`
+// frames, otherwise the XOR against the previous frame. Both are stored as
+// runs of zero words and literal non-zero words, so a frame costs roughly the
+// number of words that changed. A truncated trailing frame (crash while
+// recording) is ignored by the reader.
+//
+// Generations increase within a segment. When the recorded universe goes
+// back in time (undo, step back), the writer starts a new segment with a
+// keyframe at the earlier generation; version 1 logs hold a single segment.
+struct DeltaLogFormat {
+    static constexpr char MAGIC[8] = {'G', 'O', 'L', 'D', 'L', 'O', 'G', '\0'};
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 256;
+
+    static constexpr uint32_t FRAME_KEY = 0;
+    static constexpr uint32_t FRAME_DELTA = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t width;
+        uint32_t height;
+        uint32_t wordsPerRow;
+        uint32_t keyframeInterval;
+        uint64_t startGeneration;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(Header) == 48, "Delta log header must stay 48 bytes");
+
+    struct FrameHeader {
+        uint64_t generation;
+        uint64_t payloadSize;
+        uint32_t type;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(FrameHeader) == 24, "Delta log frame header must stay 24 bytes");
+};
+
+// Records snapshots on a background thread. The stepper only hands over a
+// copy-on-write snapshot per generation; diffing, encoding and I/O happen on
+// the writer, which keeps its own copy of the previous frame.
+class DeltaLogWriter {
+public:
+    DeltaLogWriter();
+    ~DeltaLogWriter(); // Flushes every queued frame and closes the file
+
+    DeltaLogWriter(const DeltaLogWriter&) = delete;
+    DeltaLogWriter& operator=(const DeltaLogWriter&) = delete;
+
+    // Creates the file (replacing an old one); `first` becomes its first keyframe
+    bool open(const std::string& filename, const Grid::Snapshot& first,
+              uint32_t keyframeInterval = DeltaLogFormat::DEFAULT_KEYFRAME_INTERVAL);
+    void close();
+    bool isOpen() const { return worker.joinable(); }
+
+    // Queues the next generation. Blocks while MAX_QUEUED frames are pending,
+    // so a slow disk throttles the simulation instead of dropping history.
+    // A generation not past the previous frame's starts a new segment.
+    void record(Grid::Snapshot snapshot);
+
+    std::string getError() const;
+    uint64_t getFramesWritten() const;
+    uint64_t getBytesWritten() const;
+
+    static constexpr size_t MAX_QUEUED = 8;
+
+private:
+    std::ofstream file;
+    uint32_t keyframeInterval;
+    unsigned int width;
+    unsigned int height;
+    std::vector<uint64_t> previous; // Writer thread only
+    std::vector<uint64_t> current;  // Writer thread only
+    std::vector<uint8_t> payload;   // Writer thread only
+    uint64_t lastGeneration;        // Writer thread only
+
+    mutable std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<Grid::Snapshot> queue;
+    bool stopping;
+    uint64_t framesWritten;
+    uint64_t bytesWritten;
+    std::string error;
+
+    std::thread worker;
+
+    void writerLoop();
+    bool writeFrame(const Grid::Snapshot& snapshot);
+};
+
+// Random access over a recorded log: seeking decodes forward from the nearest
+// keyframe at or before the target (or from the current frame when closer).
+// A generation recorded in several segments is taken from the latest one,
+// the history the recording ended up following; earlier branches stay
+// reachable through seek(generation, segment).
+class DeltaLogReader {
+public:
+    bool open(const std::string& filename);
+
+    bool seek(uint64_t generation);
+    bool seek(uint64_t generation, size_t segment);
+
+    unsigned int getWidth() const { return header.width; }
+    unsigned int getHeight() const { return header.height; }
+    unsigned int getWordsPerRow() const { return header.wordsPerRow; }
+    uint64_t getGeneration() const { return currentGeneration; }
+    uint64_t getFirstGeneration() const;
+    uint64_t getLastGeneration() const;
+    size_t getFrameCount() const { return frames.size(); }
+    size_t getSegmentCount() const { return segmentStarts.size(); }
+    size_t getSegment() const { return currentSegment; }
+
+    // Decoded rows of the current generation (same layout as Grid::getRow)
+    const uint64_t* getRow(unsigned int y) const { return &cells[static_cast<size_t>(y) * header.wordsPerRow]; }
+    const uint64_t* getCells() const { return cells.data(); }
+
+    const std::string& getError() const { return error; }
+
+private:
+    struct FrameEntry {
+        uint64_t generation;
+        uint64_t offset;      // Start of the payload
+        uint64_t payloadSize;
+        bool keyframe;
+    };
+
+    std::ifstream file;
+    DeltaLogFormat::Header header{};
+    std::vector<FrameEntry> frames; // In file order, generations increasing within a segment
+    std::vector<size_t> segmentStarts; // First frame of each segment, a keyframe
+    std::vector<uint64_t> cells;
+    std::vector<uint8_t> payload;
+    size_t currentFrame = 0;
+    size_t currentSegment = 0;
+    uint64_t currentGeneration = 0;
+    bool positioned = false;
+    std::string error;
+
+    size_t segmentEnd(size_t segment) const;
+    bool applyFrame(size_t index);
+};
+
+#endif // DELTALOG_HPP
@@ -0,0 +1,154 @@
+#ifndef FIXEDGRID_HPP
+#define FIXEDGRID_HPP
+
+#include "Grid.hpp"
+#include "LifeKernel.hpp"
+#include "LifeRule.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Grid with its size fixed at compile time, for embedded targets and
+// benchmarks where the universe never changes size (e.g. the 60x40 board).
+// Word counts, strides and loop bounds are constants, so the stepping loop
+// can be fully unrolled and vectorized, and both generations live inline in
+// the object with no heap allocation.
+//
+// The cell, row and hash accessors match Grid's, with the same packed row
+// layout, so code templated on the grid type works with either; load() and
+// store() copy cells to and from a dynamic Grid. Like Grid, the universe is
+// bounded and cells outside are always dead. Change tracking, tiles and
+// snapshots are left to Grid.
+//
+// The rule is fixed at compile time too, as a LifeRule index:
+// FixedGrid<64, 64, LifeRule::fromString("B36/S23").getIndex()> steps
+// HighLife with its masks folded into the kernel.
+template <unsigned int W, unsigned int H, uint32_t RULE = LifeRule().getIndex()>
+class FixedGrid {
+public:
+    static_assert(W > 0 && H > 0, "FixedGrid needs at least one cell");
+
+    static constexpr unsigned int WIDTH = W;
+    static constexpr unsigned int HEIGHT = H;
+    static constexpr unsigned int WORDS_PER_ROW = (W + 63) / 64;
+    static constexpr LifeRule getRule() { return LifeRule::fromIndex(RULE); }
+
+    // Both buffers start zeroed; the padding is never written after that
+    FixedGrid() : cells(), current(0), generation(0) {}
+    explicit FixedGrid(const Grid& grid) : cells(), current(0), generation(0) { load(grid); }
+
+    // Basic grid operations
+    void toggleCell(unsigned int x, unsigned int y) {
+        if (x < W && y < H) row(y)[x / 64] ^= 1ULL << (x % 64);
+    }
+    void setCell(unsigned int x, unsigned int y, bool alive) {
+        if (x >= W || y >= H) return;
+        uint64_t bit = 1ULL << (x % 64);
+        uint64_t& word = row(y)[x / 64];
+        word = alive ? (word | bit) : (word & ~bit);
+    }
+    bool getCell(unsigned int x, unsigned int y) const {
+        return x < W && y < H && ((getRow(y)[x / 64] >> (x % 64)) & 1ULL);
+    }
+    void clear() {
+        for (uint64_t& word : cells[current]) {
+            word = 0;
+        }
+    }
+
+    // Copies the top-left W x H cells of a Grid, or writes these cells there
+    void load(const Grid& grid) {
+        clear();
+        const unsigned int copyHeight = grid.getHeight() < H ? grid.getHeight() : H;
+        const unsigned int copyWords = grid.getWordsPerRow() < WORDS_PER_ROW ? grid.getWordsPerRow() : WORDS_PER_ROW;
+        for (unsigned int y = 0; y < copyHeight; ++y) {
+            const uint64_t* in = grid.getRow(y);
+            uint64_t* out = row(y);
+            for (unsigned int i = 0; i < copyWords; ++i) {
+                out[i] = in[i];
+            }
+            out[WORDS_PER_ROW - 1] &= LAST_WORD_MASK;
+        }
+    }
+    void store(Grid& grid) const {
+        grid.blit(getRow(0), STRIDE, W, H, 0, 0, Grid::BlitMode::Copy);
+    }
+
+    // Game logic
+    void nextGeneration() {
+        // Same bit-parallel step as Grid::stepRow, under this grid's rule. The
+        // dead padding words and rows around the universe stand in for its
+        // bounds checks, leaving a branch-free loop with constant trip counts.
+        const uint64_t* in = cells[current];
+        uint64_t* out = cells[current ^ 1];
+        for (unsigned int y = 0; y < H; ++y) {
+            const uint64_t* above = in + offset(y) - STRIDE;
+            const uint64_t* middle = in + offset(y);
+            const uint64_t* below = in + offset(y) + STRIDE;
+            uint64_t* next = out + offset(y);
+
+            for (int i = 0; i < static_cast<int>(WORDS_PER_ROW); ++i) {
+                uint64_t a = above[i];
+                uint64_t c = middle[i];
+                uint64_t b = below[i];
+                uint64_t word = lifekernel::stepRule<RULE>(
+                    (a << 1) | (above[i - 1] >> 63), a, (a >> 1) | (above[i + 1] << 63),
+                    (c << 1) | (middle[i - 1] >> 63), c, (c >> 1) | (middle[i + 1] << 63),
+                    (b << 1) | (below[i - 1] >> 63), b, (b >> 1) | (below[i + 1] << 63));
+                next[i] = i == static_cast<int>(WORDS_PER_ROW) - 1 ? word & LAST_WORD_MASK : word;
+            }
+        }
+        current ^= 1;
+        ++generation;
+    }
+    int countLiveNeighbors(unsigned int x, unsigned int y) const {
+        int liveNeighbors = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+                liveNeighbors += getCell(x + dx, y + dy) ? 1 : 0;
+            }
+        }
+        return liveNeighbors;
+    }
+
+    // Getters
+    unsigned int getWidth() const { return W; }
+    unsigned int getHeight() const { return H; }
+    unsigned int getWordsPerRow() const { return WORDS_PER_ROW; }
+    uint64_t getGeneration() const { return generation; }
+    void setGeneration(uint64_t value) { generation = value; }
+
+    // Packed row access, in Grid's layout. Unlike Grid, rows are STRIDE
+    // words apart throughout.
+    const uint64_t* getRow(unsigned int y) const { return cells[current] + offset(y); }
+    static constexpr unsigned int getRowStride() { return STRIDE; }
+
+    // Equal to Grid::getHash() for a Grid holding the same cells
+    uint64_t getHash() const {
+        uint64_t hash = 0;
+        for (unsigned int y = 0; y < H; ++y) {
+            const uint64_t* in = getRow(y);
+            for (unsigned int i = 0; i < WORDS_PER_ROW; ++i) {
+                hash ^= Grid::hashWord(static_cast<size_t>(y) * WORDS_PER_ROW + i, in[i]);
+            }
+        }
+        return hash;
+    }
+
+private:
+    // Each row has a dead padding word on either side, and a dead row sits
+    // above and below the universe
+    static constexpr unsigned int STRIDE = WORDS_PER_ROW + 2;
+    static constexpr size_t CELL_WORDS = static_cast<size_t>(STRIDE) * (H + 2);
+    static constexpr uint64_t LAST_WORD_MASK = W % 64 ? (1ULL << (W % 64)) - 1 : ~0ULL;
+
+    // Current and next generation, swapped by flipping `current`
+    uint64_t cells[2][CELL_WORDS];
+    unsigned int current;
+    uint64_t generation;
+
+    static constexpr size_t offset(unsigned int y) { return static_cast<size_t>(y + 1) * STRIDE + 1; }
+    uint64_t* row(unsigned int y) { return cells[current] + offset(y); }
+};
+
+#endif // FIXEDGRID_HPP
@@ -1,14 +1,24 @@
 #include "GameEngine.hpp"
 #include "Grid.hpp"
+#include "SnapshotFile.hpp"
+#include "Checkpointer.hpp"
+#include "DeltaLog.hpp"
+#include "UndoJournal.hpp"
+#include "RewindBuffer.hpp"
 #include "../graphics/Renderer.hpp"
 #include "../input/InputHandler.hpp"
 #include "../ui/UIManager.hpp"
 #include "../patterns/PatternManager.hpp"
+#include "../analysis/Census.hpp"
+#include "../analysis/ObjectTracker.hpp"
+#include <algorithm>
+#include <iostream>
 
 GameEngine::GameEngine() 
     : window(sf::VideoMode({WINDOW_WIDTH, WINDOW_HEIGHT}), "Conway's Game of Life", sf::Style::Default),
       paused(false),
-      timePerGeneration(sf::seconds(1.0f)) {
+      timePerGeneration(sf::seconds(1.0f)),
+      lastCheckpointGeneration(0) {
     
     initialize();
 }
@@ -69,6 +79,216 @@ float GameEngine::getSpeed() const {
     return 1.0f / timePerGeneration.asSeconds();
 }
 
+void GameEngine::paintCells(const std::vector<std::pair<unsigned int, unsigned int>>& cells, bool alive, uint64_t stroke) {
+    journal->begin(*grid);
+    grid->setCells(cells, alive);
+    journal->commit(*grid, UndoJournal::Action::Edit, stroke);
+    rewindBuffer->recordEdit(*grid);
+}
+
+void GameEngine::seedPattern(const std::string& patternName) {
+    journal->begin(*grid);
+    patternManager->applyPattern(*grid, patternName);
+    journal->commit(*grid, UndoJournal::Action::Edit);
+    rewindBuffer->recordEdit(*grid);
+}
+
+void GameEngine::clearGrid() {
+    journal->begin(*grid);
+    patternManager->clearGrid(*grid);
+    journal->commit(*grid, UndoJournal::Action::Edit);
+    rewindBuffer->recordEdit(*grid);
+}
+
+void GameEngine::undo() {
+    // Stop stepping first, otherwise the next generation would discard the redo history
+    if (!paused) {
+        pause();
+    }
+    uint64_t generation = grid->getGeneration();
+    if (journal->undo(*grid)) {
+        rewindBuffer->recordEdit(*grid);
+        recordJump(generation);
+    }
+}
+
+void GameEngine::redo() {
+    if (!paused) {
+        pause();
+    }
+    uint64_t generation = grid->getGeneration();
+    if (journal->redo(*grid)) {
+        rewindBuffer->recordEdit(*grid);
+        recordJump(generation);
+    }
+}
+
+void GameEngine::stepBackward() {
+    if (!paused) {
+        pause();
+    }
+
+    uint64_t generation = grid->getGeneration();
+    if (generation == 0 || !rewindBuffer->canRestore(generation - 1)) {
+        return;
+    }
+
+    // Journaled like an edit, so an accidental rewind can be undone
+    journal->begin(*grid);
+    rewindBuffer->restore(generation - 1, *grid);
+    journal->commit(*grid, UndoJournal::Action::Edit);
+    recordJump(generation);
+}
+
+void GameEngine::recordJump(uint64_t previousGeneration) {
+    // Going back leaves the tracker with history newer than the board
+    if (grid->getGeneration() < previousGeneration) {
+        tracker->reset();
+    }
+
+    // The log gets the generation we landed on right away: going back starts
+    // a new segment there, and a redone step is not left out of the history
+    if (recorder && grid->getGeneration() != previousGeneration) {
+        recorder->record(grid->snapshot());
+    }
+}
+
+void GameEngine::printCensus() {
+    // Built per call, so patterns loaded since startup are recognised too
+    Census census(*patternManager);
+    CensusResult result = census.run(*grid);
+
+    std::vector<std::pair<std::string, uint64_t>> counts(result.counts.begin(), result.counts.end());
+    std::stable_sort(counts.begin(), counts.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    std::cout << "Census at generation " << grid->getGeneration() << ": " << result.objects.size()
+              << " objects (" << result.seconds * 1000.0 << " ms)" << std::endl;
+    for (const auto& entry : counts) {
+        std::cout << "  " << entry.first << "\t" << entry.second << std::endl;
+    }
+
+    for (const TrackedObject& object : tracker->getObjects()) {
+        if (object.kind != ObjectKind::Spaceship && object.kind != ObjectKind::Oscillator) continue;
+        bool moving = object.kind == ObjectKind::Spaceship;
+        std::cout << "  " << (moving ? "spaceship " : "oscillator ") << object.getSpeed()
+                  << " at (" << object.x << ", " << object.y << "), " << object.population << " cells" << std::endl;
+    }
+}
+
+bool GameEngine::saveSnapshot(const std::string& filename) {
+    SnapshotFile snapshot;
+    if (!snapshot.save(*grid, filename)) {
+        std::cerr << snapshot.getError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool GameEngine::loadSnapshot(const std::string& filename) {
+    SnapshotFile snapshot;
+    std::unique_ptr<Grid> restored = snapshot.load(filename);
+    if (!restored) {
+        std::cerr << snapshot.getError() << std::endl;
+        return false;
+    }
+
+    replaceGrid(std::move(restored));
+    return true;
+}
+
+bool GameEngine::startRecording(const std::string& filename, uint32_t keyframeInterval) {
+    stopRecording();
+
+    auto writer = std::make_unique<DeltaLogWriter>();
+    if (!writer->open(filename, grid->snapshot(), keyframeInterval)) {
+        std::cerr << writer->getError() << std::endl;
+        return false;
+    }
+    recorder = std::move(writer);
+    return true;
+}
+
+void GameEngine::stopRecording() {
+    if (!recorder) return;
+
+    recorder->close();
+    std::string error = recorder->getError();
+    if (!error.empty()) {
+        std::cerr << "Recording failed: " << error << std::endl;
+    }
+    recorder.reset();
+}
+
+bool GameEngine::loadLogGeneration(const std::string& filename, uint64_t generation) {
+    DeltaLogReader reader;
+    if (!reader.open(filename) || !reader.seek(generation)) {
+        std::cerr << reader.getError() << std::endl;
+        return false;
+    }
+
+    auto restored = std::make_unique<Grid>(reader.getWidth(), reader.getHeight());
+    restored->blit(reader.getCells(), reader.getWordsPerRow(), reader.getWidth(), reader.getHeight(),
+                   0, 0, Grid::BlitMode::Copy);
+    restored->setGeneration(reader.getGeneration());
+    replaceGrid(std::move(restored));
+    return true;
+}
+
+void GameEngine::replaceGrid(std::unique_ptr<Grid> newGrid) {
+    // A recording cannot continue across a different universe
+    stopRecording();
+
+    // Journal deltas and rewind frames belong to the old grid
+    journal->clear();
+    rewindBuffer->clear();
+    tracker->reset();
+
+    grid = std::move(newGrid);
+    rewindBuffer->recordEdit(*grid);
+    renderer->invalidateMesh();
+    renderer->updateLayout(*grid);
+}
+
+void GameEngine::enableCheckpoints(const std::string& filename, float intervalSeconds) {
+    if (intervalSeconds <= 0.0f) {
+        disableCheckpoints();
+        return;
+    }
+
+    checkpointer = std::make_unique<Checkpointer>(filename);
+    checkpointInterval = sf::seconds(intervalSeconds);
+    lastCheckpointGeneration = grid->getGeneration();
+    lastCheckpointError.clear();
+    checkpointClock.restart();
+}
+
+void GameEngine::disableCheckpoints() {
+    checkpointer.reset(); // Waits for an in-flight write to finish
+}
+
+void GameEngine::updateCheckpoint() {
+    if (!checkpointer) return;
+
+    std::string error = checkpointer->getLastError();
+    if (error != lastCheckpointError) {
+        if (!error.empty()) {
+            std::cerr << "Checkpoint failed: " << error << std::endl;
+        }
+        lastCheckpointError = error;
+    }
+
+    // Skip a tick rather than queue behind a slow disk; the next one catches up
+    if (checkpointClock.getElapsedTime() < checkpointInterval || checkpointer->isBusy()) {
+        return;
+    }
+    checkpointClock.restart();
+
+    if (grid->getGeneration() != lastCheckpointGeneration) {
+        lastCheckpointGeneration = grid->getGeneration();
+        checkpointer->submit(grid->snapshot());
+    }
+}
+
 void GameEngine::initialize() {
     // Create subsystems
     grid = std::make_unique<Grid>(GRID_WIDTH, GRID_HEIGHT);
@@ -76,10 +296,14 @@ void GameEngine::initialize() {
     uiManager = std::make_unique<UIManager>(*this);
     patternManager = std::make_unique<PatternManager>();
     inputHandler = std::make_unique<InputHandler>(*this);
+    journal = std::make_unique<UndoJournal>();
+    rewindBuffer = std::make_unique<RewindBuffer>();
+    tracker = std::make_unique<ObjectTracker>(TRACKED_GENERATIONS);
+    rewindBuffer->recordEdit(*grid);
     
     // Set up input callbacks
-    inputHandler->setOnCellToggle([this](int x, int y) {
-        grid->toggleCell(x, y);
+    inputHandler->setOnCellsPaint([this](const std::vector<std::pair<unsigned int, unsigned int>>& cells, bool alive) {
+        paintCells(cells, alive, inputHandler->getPaintStroke());
     });
     
     inputHandler->setOnPauseToggle([this]() {
@@ -95,14 +319,39 @@ void GameEngine::initialize() {
     });
     
     inputHandler->setOnPatternSeed([this](const std::string& patternName) {
-        patternManager->applyPattern(*grid, patternName);
+        seedPattern(patternName);
     });
     
     inputHandler->setOnGridClear([this]() {
-        patternManager->clearGrid(*grid);
+        clearGrid();
+    });
+
+    inputHandler->setOnUndo([this]() {
+        undo();
+    });
+
+    inputHandler->setOnRedo([this]() {
+        redo();
+    });
+
+    inputHandler->setOnStepBackward([this]() {
+        stepBackward();
+    });
+
+    inputHandler->setOnCensus([this]() {
+        printCensus();
+    });
+
+    inputHandler->setOnSnapshotSave([this]() {
+        saveSnapshot(DEFAULT_SNAPSHOT_FILE);
+    });
+
+    inputHandler->setOnSnapshotLoad([this]() {
+        loadSnapshot(DEFAULT_SNAPSHOT_FILE);
     });
     
-    // Initialize UI
+    // Initialize layout and UI
+    renderer->updateLayout(*grid);
     uiManager->initializeButtons();
     
     // Start paused to allow user to set up initial pattern
@@ -111,9 +360,20 @@ void GameEngine::initialize() {
 
 void GameEngine::update() {
     if (!paused && clock.getElapsedTime() >= timePerGeneration) {
+        journal->begin(*grid);
         grid->nextGeneration();
+        journal->commit(*grid, UndoJournal::Action::Step);
+        rewindBuffer->record(*grid);
+        if (recorder) {
+            recorder->record(grid->snapshot());
+        }
         clock.restart();
     }
+
+    updateCheckpoint();
+
+    // Sees this frame's steps and edits before render() clears the change mask
+    tracker->observe(*grid);
     
     uiManager->update();
 }
@@ -124,8 +384,16 @@ void GameEngine::processEvents() {
 
 void GameEngine::render() {
     renderer->render(*grid, *uiManager);
+    grid->clearChanges();
 }
 
 void GameEngine::cleanup() {
+    // Leave a final checkpoint behind on a clean exit
+    if (checkpointer && grid->getGeneration() != lastCheckpointGeneration) {
+        checkpointer->submit(grid->snapshot());
+    }
+    disableCheckpoints();
+    stopRecording();
+
     // Unique pointers will automatically clean up
 }
\ No newline at end of file
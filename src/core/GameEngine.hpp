@@ -4,6 +4,9 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 // Forward declarations
 class Grid;
@@ -11,6 +14,11 @@ class Renderer;
 class InputHandler;
 class UIManager;
 class PatternManager;
+class Checkpointer;
+class DeltaLogWriter;
+class UndoJournal;
+class RewindBuffer;
+class ObjectTracker;
 
 class GameEngine {
 public:
@@ -32,12 +40,46 @@ public:
     void setSpeed(float generationsPerSecond);
     float getSpeed() const;
 
+    // Undoable grid edits; every generation step is journaled as well
+    void paintCells(const std::vector<std::pair<unsigned int, unsigned int>>& cells, bool alive, uint64_t stroke = 0);
+    void seedPattern(const std::string& patternName);
+    void clearGrid();
+    void undo();
+    void redo();
+
+    // Time travel: steps back one generation from the in-memory rewind buffer
+    void stepBackward();
+
+    // Prints the objects on the board (blocks, blinkers, gliders, ...) to the console,
+    // followed by the oscillators and spaceships the tracker has seen repeat
+    void printCensus();
+
+    // Universe persistence (binary snapshot, restored through a file mapping)
+    bool saveSnapshot(const std::string& filename);
+    bool loadSnapshot(const std::string& filename);
+
+    static constexpr const char* DEFAULT_SNAPSHOT_FILE = "universe.golsnap";
+
+    // Periodic crash-safe checkpoints written on a background thread
+    void enableCheckpoints(const std::string& filename, float intervalSeconds);
+    void disableCheckpoints();
+
+    static constexpr const char* DEFAULT_CHECKPOINT_FILE = "checkpoint.golsnap";
+
+    // History recording: every generation is appended to a delta log, and going
+    // back (undo, step back) continues it as a new segment from that generation
+    bool startRecording(const std::string& filename, uint32_t keyframeInterval);
+    void stopRecording();
+    // Restores one generation from a recorded delta log
+    bool loadLogGeneration(const std::string& filename, uint64_t generation);
+
     // Window management
     sf::RenderWindow& getWindow() { return window; }
     const sf::RenderWindow& getWindow() const { return window; }
 
     // Subsystem access
     Grid& getGrid() { return *grid; }
+    Renderer& getRenderer() { return *renderer; }
     UIManager& getUIManager() { return *uiManager; }
     PatternManager& getPatternManager() { return *patternManager; }
 
@@ -49,23 +91,39 @@ private:
     std::unique_ptr<InputHandler> inputHandler;
     std::unique_ptr<UIManager> uiManager;
     std::unique_ptr<PatternManager> patternManager;
+    std::unique_ptr<Checkpointer> checkpointer;
+    std::unique_ptr<DeltaLogWriter> recorder;
+    std::unique_ptr<UndoJournal> journal;
+    std::unique_ptr<RewindBuffer> rewindBuffer;
+    std::unique_ptr<ObjectTracker> tracker;
 
     // Game state
     bool paused;
     sf::Time timePerGeneration;
     sf::Clock clock;
 
+    // Checkpoint state
+    sf::Time checkpointInterval;
+    sf::Clock checkpointClock;
+    uint64_t lastCheckpointGeneration;
+    std::string lastCheckpointError;
+
     // Constants
     static constexpr unsigned int WINDOW_WIDTH = 1080 * 16 / 9;
     static constexpr unsigned int WINDOW_HEIGHT = 1080;
     static constexpr unsigned int GRID_WIDTH = 60;
     static constexpr unsigned int GRID_HEIGHT = 40;
+    static constexpr unsigned int TRACKED_GENERATIONS = 64;   // Longest period the tracker recognises
 
     // Private methods
     void initialize();
     void update();
     void processEvents();
     void render();
+    void updateCheckpoint();
+    void replaceGrid(std::unique_ptr<Grid> newGrid);
+    // Called after undo, redo or a step back moved the generation
+    void recordJump(uint64_t previousGeneration);
     void cleanup();
 };
 
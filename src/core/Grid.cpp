@@ -1,58 +1,470 @@
 #include "Grid.hpp"
+#include "BitOps.hpp"
+#include "LifeKernel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
 
 Grid::Grid(unsigned int width, unsigned int height)
-    : width(width), height(height), cells(height, std::vector<bool>(width, false)) {
+    : Grid(width, height, nullptr) {
+}
+
+Grid::Grid(unsigned int width, unsigned int height, CellBuffer storage, uint64_t generation)
+    : width(width), height(height), wordsPerRow((width + 63) / 64),
+      lastWordMask(bitops::lowMask(width - (wordsPerRow > 0 ? (wordsPerRow - 1) * 64 : 0))),
+      wordCount(static_cast<size_t>(wordsPerRow) * height),
+      tileCount((height + TILE_ROWS - 1) / TILE_ROWS),
+      generation(generation),
+      tiles(tileCount),
+      spareTiles(tileCount),
+      activeTiles(tileCount, 1),
+      nextActiveTiles(tileCount, 0),
+      changes(allocateCells(wordCount)),
+      changedRows(height, 0),
+      changesPending(false),
+      changedTop(1), changedBottom(0),
+      deltaSink(nullptr),
+      liveTop(1), liveBottom(0),
+      hash(0), hashValid(false) {
+    for (unsigned int t = 0; t < tileCount; ++t) {
+        if (storage) {
+            // Tiles alias the adopted rows; the first write to one clones it
+            tiles[t] = CellBuffer(storage, storage.get() + rowOffset(t * TILE_ROWS));
+        } else {
+            tiles[t] = allocateCells(static_cast<size_t>(tileRows(t)) * wordsPerRow);
+        }
+    }
+
+    // Adopted storage may hold live cells anywhere
+    if (storage && height > 0) {
+        liveTop = 0;
+        liveBottom = height - 1;
+    }
+}
+
+Grid::Grid(const Snapshot& snapshot)
+    : Grid(snapshot.width, 0) {
+    // Reuse the size bookkeeping of an empty grid, then take over the tiles
+    height = snapshot.height;
+    wordCount = static_cast<size_t>(wordsPerRow) * height;
+    tileCount = static_cast<unsigned int>(snapshot.tiles.size());
+    generation = snapshot.generation;
+    tiles = snapshot.tiles;
+    spareTiles.assign(tileCount, nullptr);
+    activeTiles.assign(tileCount, 1);
+    nextActiveTiles.assign(tileCount, 0);
+    changes = allocateCells(wordCount);
+    changedRows.assign(height, 0);
+    if (height > 0) {
+        liveTop = 0;
+        liveBottom = height - 1;
+    }
+}
+
+Grid::CellBuffer Grid::allocateCells(size_t count) {
+    // calloc hands back lazily zeroed pages for large blocks, so untouched
+    // regions of a huge grid cost no memory bandwidth
+    void* memory = std::calloc(std::max<size_t>(count, 1), sizeof(uint64_t));
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return CellBuffer(static_cast<uint64_t*>(memory), [](uint64_t* words) { std::free(words); });
+}
+
+Grid::Snapshot Grid::snapshot() const {
+    return Snapshot{width, height, wordsPerRow, generation, tiles};
+}
+
+bool Grid::assign(const Snapshot& snapshot) {
+    if (snapshot.width != width || snapshot.height != height || snapshot.tiles.size() != tileCount) {
+        return false;
+    }
+
+    for (unsigned int t = 0; t < tileCount; ++t) {
+        if (tiles[t] == snapshot.tiles[t]) continue; // Shared tile, nothing to compare
+
+        for (unsigned int y = t * TILE_ROWS; y < t * TILE_ROWS + tileRows(t); ++y) {
+            const uint64_t* current = getRow(y);
+            const uint64_t* target = snapshot.getRow(y);
+            uint64_t* changedRow = &changes[rowOffset(y)];
+            uint64_t rowChanges = 0;
+            for (unsigned int i = 0; i < wordsPerRow; ++i) {
+                uint64_t diff = current[i] ^ target[i];
+                if (diff) {
+                    changedRow[i] |= diff;
+                    rowChanges |= diff;
+                    recordDelta(rowOffset(y) + i, diff);
+                }
+            }
+            if (rowChanges) {
+                markRowChanged(y);
+            }
+        }
+
+        tiles[t] = snapshot.tiles[t];
+        activeTiles[t] = 1;
+        hashValid = false;
+    }
+
+    generation = snapshot.generation;
+    if (height > 0) {
+        liveTop = 0;
+        liveBottom = height - 1;
+    }
+    return true;
+}
+
+uint64_t* Grid::writableRow(unsigned int y) {
+    unsigned int t = y / TILE_ROWS;
+    CellBuffer& tile = tiles[t];
+    if (tile.use_count() > 1) {
+        // A snapshot or the spare slot still reads this tile: write to a copy
+        size_t words = static_cast<size_t>(tileRows(t)) * wordsPerRow;
+        CellBuffer copy = allocateCells(words);
+        std::copy_n(tile.get(), words, copy.get());
+        tile = std::move(copy);
+    } else {
+        // Pairs with the release in the last other holder's reference drop
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    activeTiles[t] = 1;
+    hashValid = false;
+    return &tile[rowInTile(y)];
+}
+
+bool Grid::isTileActive(int tile) const {
+    return tile >= 0 && tile < static_cast<int>(tileCount) && activeTiles[tile] != 0;
 }
 
 void Grid::toggleCell(unsigned int x, unsigned int y) {
     if (isValidPosition(x, y)) {
-        cells[y][x] = !cells[y][x];
+        writableRow(y)[x / 64] ^= 1ULL << (x % 64);
+        recordDelta(rowOffset(y) + x / 64, 1ULL << (x % 64));
+        markChanged(x, y);
+        markRowLive(y);
     }
 }
 
 void Grid::setCell(unsigned int x, unsigned int y, bool alive) {
-    if (isValidPosition(x, y)) {
-        cells[y][x] = alive;
+    if (isValidPosition(x, y) && getCell(x, y) != alive) {
+        toggleCell(x, y);
     }
 }
 
 bool Grid::getCell(unsigned int x, unsigned int y) const {
     if (isValidPosition(x, y)) {
-        return cells[y][x];
+        return (getRow(y)[x / 64] >> (x % 64)) & 1ULL;
     }
     return false;
 }
 
 void Grid::clear() {
-    for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            cells[y][x] = false;
+    if (liveTop > liveBottom) return;
+
+    for (unsigned int y = liveTop; y <= liveBottom && y < height; ++y) {
+        const uint64_t* row = getRow(y);
+        uint64_t* changedRow = &changes[rowOffset(y)];
+        uint64_t any = 0;
+        for (unsigned int i = 0; i < wordsPerRow; ++i) {
+            if (row[i]) {
+                recordDelta(rowOffset(y) + i, row[i]);
+            }
+            changedRow[i] |= row[i];
+            any |= row[i];
+        }
+        if (any) {
+            // Only rows that hold cells are written, so empty tiles stay shared
+            std::fill_n(writableRow(y), wordsPerRow, 0);
+            markRowChanged(y);
         }
     }
+
+    liveTop = 1;
+    liveBottom = 0;
 }
 
-void Grid::nextGeneration() {
-    std::vector<std::vector<bool>> nextCells(height, std::vector<bool>(width, false));
+void Grid::setCells(const std::vector<std::pair<unsigned int, unsigned int>>& positions, bool alive) {
+    for (const auto& position : positions) {
+        unsigned int x = position.first;
+        unsigned int y = position.second;
+        if (!isValidPosition(x, y)) continue;
+
+        uint64_t bit = 1ULL << (x % 64);
+        if (((getRow(y)[x / 64] & bit) != 0) != alive) {
+            writableRow(y)[x / 64] ^= bit;
+            recordDelta(rowOffset(y) + x / 64, bit);
+            markChanged(x, y);
+            markRowLive(y);
+        }
+    }
+}
+
+void Grid::fillRect(unsigned int x, unsigned int y, unsigned int rectWidth, unsigned int rectHeight, bool alive) {
+    if (x >= width || y >= height) return;
+
+    unsigned int endX = x + std::min(rectWidth, width - x);
+    unsigned int endY = y + std::min(rectHeight, height - y);
+    if (endX == x) return;
+
+    unsigned int firstWord = x / 64;
+    unsigned int lastWord = (endX - 1) / 64;
+
+    for (unsigned int row = y; row < endY; ++row) {
+        for (unsigned int i = firstWord; i <= lastWord; ++i) {
+            unsigned int wordStart = i * 64;
+            uint64_t mask = bitops::lowMask(std::min(endX - wordStart, 64u));
+            if (x > wordStart) {
+                mask &= ~bitops::lowMask(x - wordStart);
+            }
+            writeMasked(row, i, alive ? ~0ULL : 0ULL, mask, BlitMode::Copy);
+        }
+    }
+}
+
+void Grid::blit(const uint64_t* source, unsigned int sourceStride, unsigned int sourceWidth,
+                unsigned int sourceHeight, unsigned int destX, unsigned int destY, BlitMode mode) {
+    if (destX >= width || destY >= height || sourceWidth == 0) return;
+
+    // Each source word lands across at most two grid words, shifted by destX % 64
+    const unsigned int shift = destX % 64;
+    const unsigned int baseWord = destX / 64;
+    const unsigned int sourceWords = (sourceWidth + 63) / 64;
+    const unsigned int rows = std::min(sourceHeight, height - destY);
+
+    for (unsigned int row = 0; row < rows; ++row) {
+        const uint64_t* sourceRow = source + static_cast<size_t>(row) * sourceStride;
+
+        for (unsigned int j = 0; j < sourceWords && baseWord + j < wordsPerRow; ++j) {
+            uint64_t validMask = (j == sourceWords - 1) ? bitops::lowMask(sourceWidth - j * 64) : ~0ULL;
+            uint64_t bits = sourceRow[j] & validMask;
 
-    for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            int liveNeighbors = countLiveNeighbors(x, y);
+            writeMasked(destY + row, baseWord + j, bits << shift, validMask << shift, mode);
+            if (shift > 0 && baseWord + j + 1 < wordsPerRow) {
+                writeMasked(destY + row, baseWord + j + 1, bits >> (64 - shift),
+                            validMask >> (64 - shift), mode);
+            }
+        }
+    }
+}
+
+void Grid::generateRows(const std::function<void(unsigned int y, uint64_t* row)>& generator,
+                        unsigned int threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, std::max(tileCount, 1u));
+
+    // Per-tile results, merged after the workers finish so the shared
+    // bookkeeping (live band, change flag, delta sink) is touched by one thread
+    struct TileResult {
+        unsigned int liveTop = 1;
+        unsigned int liveBottom = 0;
+        unsigned int changedTop = 1;
+        unsigned int changedBottom = 0;
+        std::vector<WordDelta> deltas;
+    };
+    std::vector<TileResult> results(tileCount);
+    std::atomic<unsigned int> nextTile(0);
+
+    auto worker = [&]() {
+        std::vector<uint64_t> previous(wordsPerRow);
+        for (unsigned int t = nextTile++; t < tileCount; t = nextTile++) {
+            TileResult& result = results[t];
+            const size_t words = static_cast<size_t>(tileRows(t)) * wordsPerRow;
+            const CellBuffer old = tiles[t];
+            // Every word is overwritten, so a shared tile needs no copy
+            CellBuffer fresh = old.use_count() > 2 ? allocateCells(words) : old;
+
+            for (unsigned int y = t * TILE_ROWS; y < t * TILE_ROWS + tileRows(t); ++y) {
+                uint64_t* row = &fresh[rowInTile(y)];
+                std::copy_n(&old[rowInTile(y)], wordsPerRow, previous.begin());
+                std::fill_n(row, wordsPerRow, 0);
+                generator(y, row);
+                if (wordsPerRow > 0) {
+                    row[wordsPerRow - 1] &= lastWordMask;
+                }
+
+                uint64_t* changedRow = &changes[rowOffset(y)];
+                uint64_t rowAlive = 0;
+                uint64_t rowChanges = 0;
+                for (unsigned int i = 0; i < wordsPerRow; ++i) {
+                    uint64_t diff = row[i] ^ previous[i];
+                    if (diff && deltaSink) {
+                        result.deltas.push_back({rowOffset(y) + i, diff});
+                    }
+                    changedRow[i] |= diff;
+                    rowChanges |= diff;
+                    rowAlive |= row[i];
+                }
 
-            if (cells[y][x]) {
-                // Current cell is alive
-                if (liveNeighbors == 2 || liveNeighbors == 3) {
-                    nextCells[y][x] = true; // Survives to next generation
+                if (rowChanges) {
+                    changedRows[y] = 1;
+                    if (result.changedTop > result.changedBottom) result.changedTop = y;
+                    result.changedBottom = y;
                 }
-            } else {
-                // Current cell is dead
-                if (liveNeighbors == 3) {
-                    nextCells[y][x] = true; // Birth occurs with exactly 3 neighbors
+                if (rowAlive) {
+                    if (result.liveTop > result.liveBottom) result.liveTop = y;
+                    result.liveBottom = y;
                 }
             }
+
+            tiles[t] = std::move(fresh);
+            activeTiles[t] = 1;
         }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
     }
 
-    cells = std::move(nextCells);
+    hashValid = false;
+    liveTop = 1;
+    liveBottom = 0;
+    for (TileResult& result : results) {
+        if (result.changedTop <= result.changedBottom) {
+            markRowChanged(result.changedTop);
+            markRowChanged(result.changedBottom);
+        }
+        if (result.liveTop <= result.liveBottom) {
+            if (liveTop > liveBottom) liveTop = result.liveTop;
+            liveBottom = result.liveBottom;
+        }
+        if (deltaSink) {
+            deltaSink->insert(deltaSink->end(), result.deltas.begin(), result.deltas.end());
+        }
+    }
+}
+
+void Grid::nextGeneration() {
+    if (liveTop > liveBottom) {
+        ++generation; // Empty universe stays empty
+        return;
+    }
+
+    // Only the live band grows, by at most one row on each side
+    unsigned int first = liveTop > 0 ? liveTop - 1 : 0;
+    unsigned int last = std::min(liveBottom + 1, height - 1);
+
+    unsigned int newTop = 1;
+    unsigned int newBottom = 0;
+    auto includeRows = [&newTop, &newBottom](unsigned int top, unsigned int bottom) {
+        if (top > bottom) return;
+        if (newTop > newBottom) {
+            newTop = top;
+            newBottom = bottom;
+        } else {
+            newTop = std::min(newTop, top);
+            newBottom = std::max(newBottom, bottom);
+        }
+    };
+
+    for (unsigned int t = 0; t < tileCount; ++t) {
+        unsigned int tileTop = t * TILE_ROWS;
+        unsigned int tileBottom = tileTop + tileRows(t) - 1;
+        nextActiveTiles[t] = 0;
+
+        // Tiles outside the band are empty and stay empty. Tiles whose whole
+        // neighbourhood did not change last generation are fixed points.
+        // Both carry over by sharing the tile instead of stepping it.
+        bool outsideBand = tileBottom < first || tileTop > last;
+        int tile = static_cast<int>(t);
+        if (outsideBand || (!isTileActive(tile - 1) && !isTileActive(tile) && !isTileActive(tile + 1))) {
+            spareTiles[t] = tiles[t];
+            if (!outsideBand) {
+                includeRows(std::max(tileTop, liveTop), std::min(tileBottom, liveBottom));
+            }
+            continue;
+        }
+
+        CellBuffer& spare = spareTiles[t];
+        if (!spare || spare.use_count() > 1) {
+            spare = allocateCells(static_cast<size_t>(tileRows(t)) * wordsPerRow);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+
+        bool tileChanged = false;
+        for (unsigned int y = tileTop; y <= tileBottom; ++y) {
+            uint64_t* out = &spare[rowInTile(y)];
+            if (y < first || y > last) {
+                std::fill_n(out, wordsPerRow, 0); // Dead now and next generation
+                continue;
+            }
+
+            bool rowChanged = false;
+            if (stepRow(y, out, rowChanged)) {
+                includeRows(y, y);
+            }
+            tileChanged |= rowChanged;
+        }
+        nextActiveTiles[t] = tileChanged ? 1 : 0;
+    }
+
+    tiles.swap(spareTiles);
+    activeTiles.swap(nextActiveTiles);
+    ++generation;
+    liveTop = newTop;
+    liveBottom = newBottom;
+}
+
+bool Grid::stepRow(unsigned int y, uint64_t* out, bool& rowChanged) {
+    // Bit-parallel B3/S23: each word advances 64 cells at once by feeding the
+    // eight shifted neighbour words through the shared full-adder network.
+    const uint64_t* above = y > 0 ? getRow(y - 1) : nullptr;
+    const uint64_t* row = getRow(y);
+    const uint64_t* below = y + 1 < height ? getRow(y + 1) : nullptr;
+    uint64_t* changedRow = &changes[rowOffset(y)];
+    uint64_t rowChanges = 0;
+    uint64_t rowAlive = 0;
+
+    auto wordAt = [this](const uint64_t* r, int i) -> uint64_t {
+        return (r && i >= 0 && i < static_cast<int>(wordsPerRow)) ? r[i] : 0;
+    };
+
+    for (int i = 0; i < static_cast<int>(wordsPerRow); ++i) {
+        uint64_t a = wordAt(above, i);
+        uint64_t c = row[i];
+        uint64_t b = wordAt(below, i);
+
+        // Neighbour x-1 shifted into bit x (west) and neighbour x+1 into bit x (east)
+        uint64_t aw = (a << 1) | (wordAt(above, i - 1) >> 63);
+        uint64_t ae = (a >> 1) | (wordAt(above, i + 1) << 63);
+        uint64_t cw = (c << 1) | (wordAt(row, i - 1) >> 63);
+        uint64_t ce = (c >> 1) | (wordAt(row, i + 1) << 63);
+        uint64_t bw = (b << 1) | (wordAt(below, i - 1) >> 63);
+        uint64_t be = (b >> 1) | (wordAt(below, i + 1) << 63);
+
+        uint64_t next = lifekernel::step(aw, a, ae, cw, c, ce, bw, b, be);
+        if (i == static_cast<int>(wordsPerRow) - 1) {
+            next &= lastWordMask;
+        }
+
+        out[i] = next;
+        if (next != c) {
+            if (deltaSink) {
+                recordDelta(rowOffset(y) + i, next ^ c);
+            }
+            if (hashValid) {
+                hash ^= hashWord(rowOffset(y) + i, c) ^ hashWord(rowOffset(y) + i, next);
+            }
+        }
+        rowAlive |= next;
+        changedRow[i] |= next ^ c;
+        rowChanges |= next ^ c;
+    }
+
+    rowChanged = rowChanges != 0;
+    if (rowChanged) {
+        markRowChanged(y);
+    }
+    return rowAlive != 0;
 }
 
 int Grid::countLiveNeighbors(unsigned int x, unsigned int y) const {
@@ -67,7 +479,7 @@ int Grid::countLiveNeighbors(unsigned int x, unsigned int y) const {
 
             if (nx >= 0 && nx < static_cast<int>(width) &&
                 ny >= 0 && ny < static_cast<int>(height)) {
-                if (cells[ny][nx]) {
+                if (getCell(nx, ny)) {
                     liveNeighbors++;
                 }
             }
@@ -77,6 +489,120 @@ int Grid::countLiveNeighbors(unsigned int x, unsigned int y) const {
     return liveNeighbors;
 }
 
+uint64_t Grid::getHash() const {
+    if (!hashValid) {
+        // Rows outside the live band are empty and contribute nothing
+        hash = 0;
+        for (unsigned int y = liveTop; y <= liveBottom && y < height; ++y) {
+            const uint64_t* row = getRow(y);
+            for (unsigned int i = 0; i < wordsPerRow; ++i) {
+                hash ^= hashWord(rowOffset(y) + i, row[i]);
+            }
+        }
+        hashValid = true;
+    }
+    return hash;
+}
+
+void Grid::clearChanges() {
+    if (!changesPending) return;
+
+    for (unsigned int y = changedTop; y <= changedBottom; ++y) {
+        if (changedRows[y]) {
+            std::fill_n(&changes[rowOffset(y)], wordsPerRow, 0);
+            changedRows[y] = 0;
+        }
+    }
+    changesPending = false;
+    changedTop = 1;
+    changedBottom = 0;
+}
+
+void Grid::applyDelta(const std::vector<WordDelta>& delta) {
+    for (const WordDelta& entry : delta) {
+        if (entry.index >= wordCount || !entry.bits) continue;
+
+        unsigned int y = static_cast<unsigned int>(entry.index / wordsPerRow);
+        uint64_t& word = writableRow(y)[entry.index % wordsPerRow];
+        word ^= entry.bits;
+        changes[entry.index] |= entry.bits;
+        markRowChanged(y);
+        if (word) {
+            markRowLive(y);
+        }
+    }
+}
+
 bool Grid::isValidPosition(unsigned int x, unsigned int y) const {
     return x < width && y < height;
 }
+
+void Grid::markChanged(unsigned int x, unsigned int y) {
+    changes[rowOffset(y) + x / 64] |= 1ULL << (x % 64);
+    markRowChanged(y);
+}
+
+void Grid::markRowChanged(unsigned int y) {
+    changedRows[y] = 1;
+    changesPending = true;
+    if (changedTop > changedBottom) {
+        changedTop = y;
+        changedBottom = y;
+        return;
+    }
+    changedTop = std::min(changedTop, y);
+    changedBottom = std::max(changedBottom, y);
+}
+
+void Grid::writeMasked(unsigned int y, unsigned int wordIndex, uint64_t bits, uint64_t mask, BlitMode mode) {
+    if (wordIndex == wordsPerRow - 1) {
+        mask &= lastWordMask;
+    }
+    if (!mask) return;
+
+    size_t index = rowOffset(y) + wordIndex;
+    uint64_t before = getRow(y)[wordIndex];
+    uint64_t after = before;
+
+    switch (mode) {
+        case BlitMode::Copy:
+            after = (before & ~mask) | (bits & mask);
+            break;
+        case BlitMode::Or:
+            after = before | (bits & mask);
+            break;
+        case BlitMode::Xor:
+            after = before ^ (bits & mask);
+            break;
+    }
+
+    if (after != before) {
+        writableRow(y)[wordIndex] = after;
+        changes[index] |= after ^ before;
+        recordDelta(index, after ^ before);
+        markRowChanged(y);
+        if (after) {
+            markRowLive(y);
+        }
+    }
+}
+
+void Grid::recordDelta(size_t index, uint64_t bits) {
+    if (!deltaSink) return;
+
+    // Consecutive edits to one word (a row of setCell calls) fold into one entry
+    if (!deltaSink->empty() && deltaSink->back().index == index) {
+        deltaSink->back().bits ^= bits;
+    } else {
+        deltaSink->push_back({index, bits});
+    }
+}
+
+void Grid::markRowLive(unsigned int y) {
+    if (liveTop > liveBottom) {
+        liveTop = liveBottom = y;
+    } else {
+        liveTop = std::min(liveTop, y);
+        liveBottom = std::max(liveBottom, y);
+    }
+}
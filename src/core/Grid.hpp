@@ -1,35 +1,180 @@
 #ifndef GRID_HPP
 #define GRID_HPP
 
+#include "CounterRng.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
 #include <vector>
 
 class Grid {
 public:
+    // How blitted bits combine with the cells already in the grid
+    enum class BlitMode {
+        Copy,   // Replace the covered cells
+        Or,     // Add live cells, keep existing ones
+        Xor     // Toggle the cells set in the source
+    };
+
+    // Word storage shared with whoever allocated it (heap or a file mapping)
+    using CellBuffer = std::shared_ptr<uint64_t[]>;
+
+    // Rows are stored in refcounted tiles of TILE_ROWS rows. A tile is only
+    // written while the grid holds the sole reference; otherwise it is cloned
+    // first, so snapshots share every tile the simulation has not touched.
+    static constexpr unsigned int TILE_ROWS = 64;
+
+    // One changed word: XOR `bits` into word `index` (row-major, getRow layout)
+    struct WordDelta {
+        size_t index;
+        uint64_t bits;
+    };
+
+    // Immutable view of one generation, taken in O(number of tiles). It can
+    // be read from another thread while the simulation keeps stepping.
+    struct Snapshot {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int wordsPerRow = 0;
+        uint64_t generation = 0;
+        std::vector<CellBuffer> tiles;
+
+        const uint64_t* getRow(unsigned int y) const {
+            return &tiles[y / TILE_ROWS][static_cast<size_t>(y % TILE_ROWS) * wordsPerRow];
+        }
+        unsigned int getTileRows(size_t tile) const {
+            return std::min(TILE_ROWS, height - static_cast<unsigned int>(tile) * TILE_ROWS);
+        }
+    };
+
     Grid(unsigned int width, unsigned int height);
-    
+    // Adopts existing packed rows (height * wordsPerRow words) as the backing
+    // store, e.g. a memory-mapped snapshot; pages are only touched when read
+    Grid(unsigned int width, unsigned int height, CellBuffer storage, uint64_t generation = 0);
+    // Starts from a snapshot, sharing its tiles until they are written
+    explicit Grid(const Snapshot& snapshot);
+
     // Basic grid operations
     void toggleCell(unsigned int x, unsigned int y);
     void setCell(unsigned int x, unsigned int y, bool alive);
     bool getCell(unsigned int x, unsigned int y) const;
     void clear();
-    
+
+    // Bulk edits, clipped to the grid (out-of-range positions are skipped)
+    void setCells(const std::vector<std::pair<unsigned int, unsigned int>>& positions, bool alive);
+    void fillRect(unsigned int x, unsigned int y, unsigned int rectWidth, unsigned int rectHeight, bool alive);
+    // Blits a packed bitmap (same bit layout as getRow, `sourceStride` words per row)
+    void blit(const uint64_t* source, unsigned int sourceStride, unsigned int sourceWidth,
+              unsigned int sourceHeight, unsigned int destX, unsigned int destY,
+              BlitMode mode = BlitMode::Or);
+
+    // Rewrites every row with generator(y, row), where row arrives zeroed and
+    // bits past the width are discarded. Tiles are processed on up to
+    // `threads` threads (0 = one per core), so the generator must be safe to
+    // call concurrently for different rows.
+    void generateRows(const std::function<void(unsigned int y, uint64_t* row)>& generator,
+                      unsigned int threads = 0);
+
     // Game logic
     void nextGeneration();
     int countLiveNeighbors(unsigned int x, unsigned int y) const;
-    
+
     // Getters
     unsigned int getWidth() const { return width; }
     unsigned int getHeight() const { return height; }
-    
-    // Grid access for rendering
-    const std::vector<std::vector<bool>>& getCells() const { return cells; }
+    unsigned int getWordsPerRow() const { return wordsPerRow; }
+    uint64_t getGeneration() const { return generation; }
+    void setGeneration(uint64_t value) { generation = value; }
+    // Conservative band of rows that may hold live cells; top > bottom when empty
+    unsigned int getLiveTop() const { return liveTop; }
+    unsigned int getLiveBottom() const { return std::min(liveBottom, height - 1); }
+
+    // Packed row access: cell x lives in bit (x % 64) of word (x / 64).
+    // Rows are contiguous within a tile, not across the whole grid.
+    const uint64_t* getRow(unsigned int y) const { return &tiles[y / TILE_ROWS][rowInTile(y)]; }
+    Snapshot snapshot() const;
+    // Replaces the contents with a snapshot of the same size. Only tiles that
+    // differ are compared and reported as changes (and as deltas).
+    bool assign(const Snapshot& snapshot);
+
+    // Change tracking for incremental rendering. The mask holds every cell
+    // flipped by a generation or an edit since the last clearChanges().
+    bool hasChanges() const { return changesPending; }
+    bool isRowChanged(unsigned int y) const { return changedRows[y] != 0; }
+    // Band of rows holding changes; top > bottom when there are none
+    unsigned int getChangedTop() const { return changedTop; }
+    unsigned int getChangedBottom() const { return changedBottom; }
+    const uint64_t* getChangedRow(unsigned int y) const { return &changes[rowOffset(y)]; }
+    void clearChanges();
+
+    // Delta capture for undo: while a sink is set, every word that an edit or
+    // a generation changes is appended to it as an XOR delta. Applying the
+    // same deltas again reverts the change at a cost proportional to its size.
+    void setDeltaSink(std::vector<WordDelta>* sink) { deltaSink = sink; }
+    void applyDelta(const std::vector<WordDelta>& delta);
+
+    // Position-dependent hash of the whole universe: the XOR of hashWord over
+    // every word. The first call scans the live rows; after that the stepper
+    // updates it for the words each generation changes, so polling it every
+    // generation costs next to nothing. Edits make the next call rescan.
+    uint64_t getHash() const;
+    static uint64_t hashWord(size_t index, uint64_t word) {
+        return word ? counterrng::at(word, index) : 0;
+    }
 
 private:
-    std::vector<std::vector<bool>> cells;
     unsigned int width;
     unsigned int height;
-    
+    unsigned int wordsPerRow;
+    uint64_t lastWordMask;
+    size_t wordCount;
+    unsigned int tileCount;
+    uint64_t generation;
+
+    // Current and spare generation tiles. A spare slot may be empty or share
+    // a tile with `tiles`; it is replaced before the stepper writes to it.
+    std::vector<CellBuffer> tiles;
+    std::vector<CellBuffer> spareTiles;
+    // Tiles that changed in the last generation or were edited since. A tile
+    // whose neighbourhood is all inactive is a fixed point and is not stepped.
+    std::vector<uint8_t> activeTiles;
+    std::vector<uint8_t> nextActiveTiles;
+
+    CellBuffer changes;
+    std::vector<uint8_t> changedRows;
+    bool changesPending;
+    // Rows outside this band hold no changes, so clearing and readers of the
+    // mask skip them (top > bottom means no changes)
+    unsigned int changedTop;
+    unsigned int changedBottom;
+    std::vector<WordDelta>* deltaSink;
+
+    // Conservative band of rows that may hold live cells (top > bottom means
+    // empty). Stepping and clearing only touch these rows, so sparse
+    // universes stay cheap.
+    unsigned int liveTop;
+    unsigned int liveBottom;
+
+    // Cached getHash() value, maintained by the stepper while valid
+    mutable uint64_t hash;
+    mutable bool hashValid;
+
+    static CellBuffer allocateCells(size_t count);
+    size_t rowOffset(unsigned int y) const { return static_cast<size_t>(y) * wordsPerRow; }
+    size_t rowInTile(unsigned int y) const { return static_cast<size_t>(y % TILE_ROWS) * wordsPerRow; }
+    unsigned int tileRows(unsigned int tile) const { return std::min(TILE_ROWS, height - tile * TILE_ROWS); }
     bool isValidPosition(unsigned int x, unsigned int y) const;
+    uint64_t* writableRow(unsigned int y);
+    bool isTileActive(int tile) const;
+    void markChanged(unsigned int x, unsigned int y);
+    void markRowChanged(unsigned int y);
+    void markRowLive(unsigned int y);
+    void recordDelta(size_t index, uint64_t bits);
+    void writeMasked(unsigned int y, unsigned int wordIndex, uint64_t bits, uint64_t mask, BlitMode mode);
+    bool stepRow(unsigned int y, uint64_t* out, bool& rowChanged);
 };
 
 #endif // GRID_HPP
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "LaneGrid.hpp"
+#include "Grid.hpp"
+#include "LifeKernel.hpp"
+#include <algorithm>
+
+LaneGrid::LaneGrid(unsigned int width, unsigned int height)
+    : width(width),
+      height(height),
+      stride(width + 2),
+      generation(0),
+      changedLanes(0),
+      birthLanes(),
+      survivalLanes(),
+      lifeOnly(true),
+      cells(static_cast<size_t>(width + 2) * (height + 2), 0),
+      nextCells(cells.size(), 0) {
+    setRule(LifeRule());
+}
+
+void LaneGrid::setCell(unsigned int lane, unsigned int x, unsigned int y, bool alive) {
+    if (lane >= LANES || x >= width || y >= height) return;
+    uint64_t bit = 1ULL << lane;
+    uint64_t& word = cells[index(x, y)];
+    word = alive ? (word | bit) : (word & ~bit);
+    if (alive) {
+        includeLive(x, y);
+    }
+}
+
+bool LaneGrid::getCell(unsigned int lane, unsigned int x, unsigned int y) const {
+    if (lane >= LANES || x >= width || y >= height) return false;
+    return (cells[index(x, y)] >> lane) & 1ULL;
+}
+
+void LaneGrid::clear() {
+    for (int y = live.top; y <= live.bottom; ++y) {
+        std::fill_n(&cells[index(live.left, y)], live.right - live.left + 1, 0);
+    }
+    live = Box();
+    changedLanes = 0;
+}
+
+void LaneGrid::clearLane(unsigned int lane) {
+    if (lane >= LANES) return;
+    uint64_t keep = ~(1ULL << lane);
+    for (int y = live.top; y <= live.bottom; ++y) {
+        uint64_t* row = &cells[index(0, y)];
+        for (int x = live.left; x <= live.right; ++x) {
+            row[x] &= keep;
+        }
+    }
+}
+
+void LaneGrid::loadLane(unsigned int lane, const uint64_t* rows, unsigned int sourceStride,
+                        unsigned int sourceWidth, unsigned int sourceHeight) {
+    if (lane >= LANES) return;
+    clearLane(lane);
+
+    const unsigned int copyWidth = std::min(width, sourceWidth);
+    const unsigned int copyHeight = std::min(height, sourceHeight);
+    for (unsigned int y = 0; y < copyHeight; ++y) {
+        const uint64_t* row = rows + static_cast<size_t>(y) * sourceStride;
+        uint64_t* out = &cells[index(0, y)];
+        for (unsigned int x = 0; x < copyWidth; ++x) {
+            out[x] |= ((row[x / 64] >> (x % 64)) & 1ULL) << lane;
+        }
+    }
+    if (copyWidth > 0 && copyHeight > 0) {
+        includeLive(0, 0);
+        includeLive(copyWidth - 1, copyHeight - 1);
+    }
+}
+
+void LaneGrid::loadLane(unsigned int lane, const Grid& grid) {
+    if (lane >= LANES) return;
+    clearLane(lane);
+
+    // Grid rows are only contiguous within a tile, so copy row by row
+    const unsigned int copyWidth = std::min(width, grid.getWidth());
+    const unsigned int copyHeight = std::min(height, grid.getHeight());
+    for (unsigned int y = 0; y < copyHeight; ++y) {
+        const uint64_t* row = grid.getRow(y);
+        uint64_t* out = &cells[index(0, y)];
+        for (unsigned int x = 0; x < copyWidth; ++x) {
+            out[x] |= ((row[x / 64] >> (x % 64)) & 1ULL) << lane;
+        }
+    }
+    if (copyWidth > 0 && copyHeight > 0) {
+        includeLive(0, 0);
+        includeLive(copyWidth - 1, copyHeight - 1);
+    }
+}
+
+void LaneGrid::loadAll(const uint64_t* rows, unsigned int sourceStride,
+                       unsigned int sourceWidth, unsigned int sourceHeight) {
+    clear();
+
+    const unsigned int copyWidth = std::min(width, sourceWidth);
+    const unsigned int copyHeight = std::min(height, sourceHeight);
+    for (unsigned int y = 0; y < copyHeight; ++y) {
+        const uint64_t* row = rows + static_cast<size_t>(y) * sourceStride;
+        uint64_t* out = &cells[index(0, y)];
+        for (unsigned int x = 0; x < copyWidth; ++x) {
+            out[x] = ((row[x / 64] >> (x % 64)) & 1ULL) ? ~0ULL : 0;
+        }
+    }
+    if (copyWidth > 0 && copyHeight > 0) {
+        includeLive(0, 0);
+        includeLive(copyWidth - 1, copyHeight - 1);
+    }
+}
+
+void LaneGrid::storeLane(unsigned int lane, Grid& grid) const {
+    if (lane >= LANES) return;
+
+    const unsigned int wordsPerRow = (width + 63) / 64;
+    std::vector<uint64_t> rows(static_cast<size_t>(wordsPerRow) * height, 0);
+    for (unsigned int y = 0; y < height; ++y) {
+        const uint64_t* in = &cells[index(0, y)];
+        uint64_t* row = &rows[static_cast<size_t>(y) * wordsPerRow];
+        for (unsigned int x = 0; x < width; ++x) {
+            row[x / 64] |= ((in[x] >> lane) & 1ULL) << (x % 64);
+        }
+    }
+    grid.blit(rows.data(), wordsPerRow, width, height, 0, 0, Grid::BlitMode::Copy);
+}
+
+void LaneGrid::setRule(unsigned int lane, const LifeRule& rule) {
+    if (lane >= LANES) return;
+    uint64_t bit = 1ULL << lane;
+    for (unsigned int n = 0; n < LifeRule::NEIGHBOUR_COUNTS; ++n) {
+        birthLanes[n] = ((rule.birth >> n) & 1u) ? (birthLanes[n] | bit) : (birthLanes[n] & ~bit);
+        survivalLanes[n] = ((rule.survival >> n) & 1u) ? (survivalLanes[n] | bit) : (survivalLanes[n] & ~bit);
+    }
+
+    const LifeRule life;
+    lifeOnly = true;
+    for (unsigned int n = 0; n < LifeRule::NEIGHBOUR_COUNTS; ++n) {
+        lifeOnly = lifeOnly && birthLanes[n] == (((life.birth >> n) & 1u) ? ~0ULL : 0) &&
+                   survivalLanes[n] == (((life.survival >> n) & 1u) ? ~0ULL : 0);
+    }
+}
+
+void LaneGrid::setRule(const LifeRule& rule) {
+    for (unsigned int lane = 0; lane < LANES; ++lane) {
+        setRule(lane, rule);
+    }
+}
+
+LifeRule LaneGrid::getRule(unsigned int lane) const {
+    LifeRule rule;
+    rule.birth = 0;
+    rule.survival = 0;
+    if (lane >= LANES) return rule;
+    for (unsigned int n = 0; n < LifeRule::NEIGHBOUR_COUNTS; ++n) {
+        rule.birth |= static_cast<uint16_t>(((birthLanes[n] >> lane) & 1ULL) << n);
+        rule.survival |= static_cast<uint16_t>(((survivalLanes[n] >> lane) & 1ULL) << n);
+    }
+    return rule;
+}
+
+void LaneGrid::nextGeneration() {
+    // Only the live box grown by one cell can change. The spare buffer's box
+    // is stepped too, so whatever it still holds from two generations ago is
+    // overwritten. A rule with B0 brings empty space to life, so it steps
+    // the whole grid.
+    Box region;
+    if (birthLanes[0]) {
+        region = Box{0, 0, static_cast<int>(width) - 1, static_cast<int>(height) - 1};
+    } else if (!live.empty()) {
+        region = Box{std::max(live.left - 1, 0), std::max(live.top - 1, 0),
+                     std::min(live.right + 1, static_cast<int>(width) - 1),
+                     std::min(live.bottom + 1, static_cast<int>(height) - 1)};
+    }
+    region = unite(region, spare);
+
+    // Neighbours of a lane word are the adjacent words themselves, so no
+    // shifting is needed and the inner loop is straight-line code over
+    // contiguous memory that the compiler can vectorize
+    uint64_t changed = 0;
+    Box next;
+    for (int y = region.top; y <= region.bottom; ++y) {
+        const uint64_t* above = &cells[index(0, y) - stride];
+        const uint64_t* row = &cells[index(0, y)];
+        const uint64_t* below = &cells[index(0, y) + stride];
+        uint64_t* out = &nextCells[index(0, y)];
+
+        uint64_t rowLive = 0;
+        if (lifeOnly) {
+            for (int x = region.left; x <= region.right; ++x) {
+                uint64_t word = lifekernel::step(above[x - 1], above[x], above[x + 1],
+                                                 row[x - 1], row[x], row[x + 1],
+                                                 below[x - 1], below[x], below[x + 1]);
+                changed |= word ^ row[x];
+                rowLive |= word;
+                out[x] = word;
+            }
+        } else {
+            for (int x = region.left; x <= region.right; ++x) {
+                uint64_t word = lifekernel::stepRule(birthLanes.data(), survivalLanes.data(),
+                                                     above[x - 1], above[x], above[x + 1],
+                                                     row[x - 1], row[x], row[x + 1],
+                                                     below[x - 1], below[x], below[x + 1]);
+                changed |= word ^ row[x];
+                rowLive |= word;
+                out[x] = word;
+            }
+        }
+
+        if (rowLive) {
+            int left = region.left;
+            int right = region.right;
+            while (!out[left]) ++left;
+            while (!out[right]) --right;
+            next = unite(next, Box{left, y, right, y});
+        }
+    }
+
+    cells.swap(nextCells);
+    spare = live;
+    live = next;
+    changedLanes = changed;
+    ++generation;
+}
+
+LaneGrid::Box LaneGrid::unite(const Box& a, const Box& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return Box{std::min(a.left, b.left), std::min(a.top, b.top),
+               std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+}
+
+void LaneGrid::includeLive(unsigned int x, unsigned int y) {
+    const int column = static_cast<int>(x);
+    const int row = static_cast<int>(y);
+    live = unite(live, Box{column, row, column, row});
+}
+
+uint64_t LaneGrid::getLiveLanes() const {
+    uint64_t lanes = 0;
+    for (int y = live.top; y <= live.bottom; ++y) {
+        const uint64_t* row = &cells[index(0, y)];
+        for (int x = live.left; x <= live.right; ++x) {
+            lanes |= row[x];
+        }
+    }
+    return lanes;
+}
+
+std::array<uint64_t, LaneGrid::LANES> LaneGrid::getPopulations() const {
+    // Bit-sliced counters: plane k holds bit k of every lane's running count,
+    // so each word is added to all 64 counts with a few carry steps
+    std::array<uint64_t, LANES> planes{};
+    for (int y = live.top; y <= live.bottom; ++y) {
+        const uint64_t* row = &cells[index(0, y)];
+        for (int x = live.left; x <= live.right; ++x) {
+            uint64_t word = row[x];
+            for (unsigned int k = 0; word && k < LANES; ++k) {
+                uint64_t carry = planes[k] & word;
+                planes[k] ^= word;
+                word = carry;
+            }
+        }
+    }
+
+    std::array<uint64_t, LANES> populations{};
+    for (unsigned int lane = 0; lane < LANES; ++lane) {
+        for (unsigned int k = 0; k < LANES; ++k) {
+            populations[lane] |= ((planes[k] >> lane) & 1ULL) << k;
+        }
+    }
+    return populations;
+}
+
+uint64_t LaneGrid::getDifferingLanes(const LaneGrid& other) const {
+    if (other.width != width || other.height != height) return ~0ULL;
+
+    // Outside both live boxes every word is zero on either side
+    const Box both = unite(live, other.live);
+    uint64_t differing = 0;
+    for (int y = both.top; y <= both.bottom; ++y) {
+        const uint64_t* row = &cells[index(0, y)];
+        const uint64_t* otherRow = &other.cells[index(0, y)];
+        for (int x = both.left; x <= both.right; ++x) {
+            differing |= row[x] ^ otherRow[x];
+        }
+    }
+    return differing;
+}
+
+uint64_t LaneGrid::getEdgeLanes(unsigned int margin) const {
+    // Only the live box can hold cells; rows away from the top and bottom
+    // bands contribute just their outer columns
+    const int band = static_cast<int>(std::min(margin, std::max(width, height)));
+    const int lastX = static_cast<int>(width) - 1;
+    const int lastY = static_cast<int>(height) - 1;
+    uint64_t edge = 0;
+    for (int y = live.top; y <= live.bottom; ++y) {
+        const uint64_t* row = &cells[index(0, y)];
+        if (y < band || y > lastY - band) {
+            for (int x = live.left; x <= live.right; ++x) {
+                edge |= row[x];
+            }
+            continue;
+        }
+        for (int x = live.left; x <= std::min(live.right, band - 1); ++x) {
+            edge |= row[x];
+        }
+        for (int x = std::max(live.left, lastX - band + 1); x <= live.right; ++x) {
+            edge |= row[x];
+        }
+    }
+    return edge;
+}
@@ -0,0 +1,108 @@
+#ifndef LANEGRID_HPP
+#define LANEGRID_HPP
+
+#include "LifeRule.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Grid;
+
+// 64 independent small universes stepped together. The grid is transposed
+// into bit lanes: the word at (x, y) holds that cell of every universe, bit
+// k belonging to lane k. One pass of the shared kernel over width * height
+// words advances all 64 universes, which suits batch workloads (soups, rule
+// sweeps) on grids too small to fill a packed Grid row.
+//
+// Every lane runs B3/S23 unless given its own rule with setRule, so a rule
+// sweep steps 64 Life-like rules in the same pass. Like Grid, the universes
+// are bounded: cells outside are always dead, whatever the rule.
+//
+// Stepping only visits the box that may hold live cells in some lane, grown
+// by one cell, so a batch of small soups in a large arena costs what their
+// combined extent covers rather than the whole arena.
+class LaneGrid {
+public:
+    static constexpr unsigned int LANES = 64;
+
+    LaneGrid(unsigned int width, unsigned int height);
+
+    // Per-lane cell access
+    void setCell(unsigned int lane, unsigned int x, unsigned int y, bool alive);
+    bool getCell(unsigned int lane, unsigned int x, unsigned int y) const;
+    void clear();
+    void clearLane(unsigned int lane);
+
+    // Loads packed rows (Grid bit layout, `sourceStride` words per row) into one
+    // lane, clipped to the lane grid; the rest of the lane is cleared
+    void loadLane(unsigned int lane, const uint64_t* rows, unsigned int sourceStride,
+                  unsigned int sourceWidth, unsigned int sourceHeight);
+    void loadLane(unsigned int lane, const Grid& grid);
+    // Loads the same packed rows into every lane
+    void loadAll(const uint64_t* rows, unsigned int sourceStride,
+                 unsigned int sourceWidth, unsigned int sourceHeight);
+    // Copies one lane into the top-left corner of a Grid, replacing its cells there
+    void storeLane(unsigned int lane, Grid& grid) const;
+
+    // Rule of one lane, and of every lane at once
+    void setRule(unsigned int lane, const LifeRule& rule);
+    void setRule(const LifeRule& rule);
+    LifeRule getRule(unsigned int lane) const;
+
+    void nextGeneration();
+
+    // Lanes whose cells changed in the last generation, and lanes with any live cell
+    uint64_t getChangedLanes() const { return changedLanes; }
+    uint64_t getLiveLanes() const;
+    std::array<uint64_t, LANES> getPopulations() const;
+    // Lanes whose cells differ from the same lane of a grid of the same size
+    uint64_t getDifferingLanes(const LaneGrid& other) const;
+    // Lanes with a live cell within `margin` rows or columns of the edge
+    uint64_t getEdgeLanes(unsigned int margin = 1) const;
+
+    unsigned int getWidth() const { return width; }
+    unsigned int getHeight() const { return height; }
+    uint64_t getGeneration() const { return generation; }
+    void setGeneration(uint64_t value) { generation = value; }
+
+    // The lane words of row y, one per column
+    const uint64_t* getRow(unsigned int y) const { return &cells[index(0, y)]; }
+
+private:
+    unsigned int width;
+    unsigned int height;
+    unsigned int stride;   // width plus a dead column on each side
+    uint64_t generation;
+    uint64_t changedLanes;
+
+    // Bit k of birthLanes[n] (survivalLanes[n]) holds lane k's rule for n
+    // neighbours; lifeOnly skips the general kernel while every lane is B3/S23
+    std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> birthLanes;
+    std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> survivalLanes;
+    bool lifeOnly;
+
+    // Current and next generation with a one-cell dead border, so the
+    // stepping loop reads neighbours without bounds checks
+    std::vector<uint64_t> cells;
+    std::vector<uint64_t> nextCells;
+
+    // Inclusive box outside which every word is zero (empty when left > right)
+    struct Box {
+        int left = 0;
+        int top = 0;
+        int right = -1;
+        int bottom = -1;
+        bool empty() const { return left > right || top > bottom; }
+    };
+    Box live;    // Of cells
+    Box spare;   // Of nextCells, which the next generation overwrites
+
+    size_t index(unsigned int x, unsigned int y) const {
+        return static_cast<size_t>(y + 1) * stride + x + 1;
+    }
+    static Box unite(const Box& a, const Box& b);
+    void includeLive(unsigned int x, unsigned int y);
+};
+
+#endif // LANEGRID_HPP
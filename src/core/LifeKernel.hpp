@@ -0,0 +1,128 @@
+#ifndef LIFEKERNEL_HPP
+#define LIFEKERNEL_HPP
+
+#include "LifeRule.hpp"
+#include <array>
+#include <cstdint>
+
+// Bit-parallel B3/S23 step shared by the engines. Every bit position is an
+// independent cell: given the word of cells and the eight words holding each
+// cell's neighbours in the same bit, the result holds the next generation.
+// Grid lines the neighbours up by shifting adjacent columns into place;
+// LaneGrid's words already hold one cell of 64 universes, so it passes the
+// neighbouring words as they are.
+//
+// stepRule generalises this to a different Life-like rule in every bit
+// position, from the exact neighbour count. stepRule<index> fixes one rule
+// at compile time, e.g. stepRule<LifeRule::fromString("B36/S23").getIndex()>,
+// letting the compiler fold the masks into the adder network.
+namespace lifekernel {
+
+inline uint64_t step(uint64_t nw, uint64_t n, uint64_t ne,
+                     uint64_t w, uint64_t c, uint64_t e,
+                     uint64_t sw, uint64_t s, uint64_t se) {
+    // Column sums of the row above and below (0..3 each), and the middle pair (0..2)
+    uint64_t aSum = nw ^ n ^ ne;
+    uint64_t aCarry = (nw & n) | (ne & (nw ^ n));
+    uint64_t bSum = sw ^ s ^ se;
+    uint64_t bCarry = (sw & s) | (se & (sw ^ s));
+    uint64_t mSum = w ^ e;
+    uint64_t mCarry = w & e;
+
+    // Combine into the ones, twos and "four or more" bit planes
+    uint64_t ones = aSum ^ bSum ^ mSum;
+    uint64_t onesCarry = (aSum & bSum) | (mSum & (aSum ^ bSum));
+    uint64_t twosSum = aCarry ^ bCarry ^ mCarry;
+    uint64_t twosCarry = (aCarry & bCarry) | (mCarry & (aCarry ^ bCarry));
+    uint64_t twos = twosSum ^ onesCarry;
+    uint64_t fours = twosCarry | (twosSum & onesCarry);
+
+    // Alive next generation with exactly 3 neighbours, or 2 while already alive
+    return twos & ~fours & (ones | c);
+}
+
+// Exact neighbour count (0 to 8) of every bit position as four bit planes
+struct NeighbourCount {
+    uint64_t ones;
+    uint64_t twos;
+    uint64_t fours;
+    uint64_t eights;
+};
+
+inline NeighbourCount countNeighbours(uint64_t nw, uint64_t n, uint64_t ne,
+                                      uint64_t w, uint64_t e,
+                                      uint64_t sw, uint64_t s, uint64_t se) {
+    // Same adder tree as step(), carried through to the eights plane
+    uint64_t aSum = nw ^ n ^ ne;
+    uint64_t aCarry = (nw & n) | (ne & (nw ^ n));
+    uint64_t bSum = sw ^ s ^ se;
+    uint64_t bCarry = (sw & s) | (se & (sw ^ s));
+    uint64_t mSum = w ^ e;
+    uint64_t mCarry = w & e;
+
+    uint64_t onesCarry = (aSum & bSum) | (mSum & (aSum ^ bSum));
+    uint64_t twosSum = aCarry ^ bCarry ^ mCarry;
+    uint64_t twosCarry = (aCarry & bCarry) | (mCarry & (aCarry ^ bCarry));
+    uint64_t foursCarry = twosSum & onesCarry;
+
+    NeighbourCount count;
+    count.ones = aSum ^ bSum ^ mSum;
+    count.twos = twosSum ^ onesCarry;
+    count.fours = twosCarry ^ foursCarry;
+    count.eights = twosCarry & foursCarry;
+    return count;
+}
+
+// One step under per-bit rules: bit k of birth[n] (survival[n]) is set when
+// the rule in bit position k gives birth to (keeps alive) a cell with n
+// neighbours. For the same rule in every bit, use masks of all ones or zeros.
+inline uint64_t stepRule(const uint64_t* birth, const uint64_t* survival,
+                         uint64_t nw, uint64_t n, uint64_t ne,
+                         uint64_t w, uint64_t c, uint64_t e,
+                         uint64_t sw, uint64_t s, uint64_t se) {
+    NeighbourCount count = countNeighbours(nw, n, ne, w, e, sw, s, se);
+    uint64_t low = ~count.fours & ~count.eights;  // 0 to 3 neighbours
+    uint64_t high = count.fours;                  // 4 to 7
+    uint64_t ones = count.ones;
+    uint64_t twos = count.twos;
+
+    // Which count each bit has, as nine disjoint masks
+    uint64_t is[9] = {
+        low & ~twos & ~ones, low & ~twos & ones, low & twos & ~ones, low & twos & ones,
+        high & ~twos & ~ones, high & ~twos & ones, high & twos & ~ones, high & twos & ones,
+        count.eights
+    };
+
+    uint64_t next = 0;
+    for (int k = 0; k < 9; ++k) {
+        next |= is[k] & ((c & survival[k]) | (~c & birth[k]));
+    }
+    return next;
+}
+
+// Mask per neighbour count: all ones where `bits` has that count set
+constexpr std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> countMasks(uint16_t bits) {
+    std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> masks{};
+    for (unsigned int n = 0; n < LifeRule::NEIGHBOUR_COUNTS; ++n) {
+        masks[n] = ((bits >> n) & 1u) ? ~0ULL : 0;
+    }
+    return masks;
+}
+
+template <uint32_t RuleIndex>
+inline uint64_t stepRule(uint64_t nw, uint64_t n, uint64_t ne,
+                         uint64_t w, uint64_t c, uint64_t e,
+                         uint64_t sw, uint64_t s, uint64_t se) {
+    constexpr LifeRule rule = LifeRule::fromIndex(RuleIndex);
+    if constexpr (rule == LifeRule()) {
+        return step(nw, n, ne, w, c, e, sw, s, se);
+    } else {
+        static constexpr std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> birth = countMasks(rule.birth);
+        static constexpr std::array<uint64_t, LifeRule::NEIGHBOUR_COUNTS> survival = countMasks(rule.survival);
+        return stepRule(birth.data(), survival.data(), nw, n, ne, w, c, e, sw, s, se);
+    }
+}
+
+} // namespace lifekernel
+
+#endif // LIFEKERNEL_HPP
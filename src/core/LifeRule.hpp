@@ -0,0 +1,101 @@
+#ifndef LIFERULE_HPP
+#define LIFERULE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Outer-totalistic ("Life-like") rule in B/S notation. Bit n of `birth` is
+// set when a dead cell with n live neighbours comes alive, bit n of
+// `survival` when a live cell with n live neighbours stays alive. The
+// default is Conway's B3/S23.
+//
+// Everything but toString() is constexpr, so a rule written as a string
+// literal becomes masks at compile time: LifeRule::fromString("B36/S23").
+struct LifeRule {
+    static constexpr unsigned int NEIGHBOUR_COUNTS = 9;   // 0 to 8 neighbours
+    static constexpr uint32_t RULE_COUNT = 1u << (2 * NEIGHBOUR_COUNTS);
+
+    uint16_t birth = 1u << 3;
+    uint16_t survival = (1u << 2) | (1u << 3);
+
+    // Every rule as an index in [0, RULE_COUNT): birth bits, then survival bits
+    static constexpr LifeRule fromIndex(uint32_t index) {
+        LifeRule rule;
+        rule.birth = static_cast<uint16_t>(index & 0x1FF);
+        rule.survival = static_cast<uint16_t>((index >> NEIGHBOUR_COUNTS) & 0x1FF);
+        return rule;
+    }
+    constexpr uint32_t getIndex() const { return birth | (static_cast<uint32_t>(survival) << NEIGHBOUR_COUNTS); }
+
+    constexpr bool operator==(const LifeRule& other) const { return birth == other.birth && survival == other.survival; }
+    constexpr bool operator!=(const LifeRule& other) const { return !(*this == other); }
+
+    std::string toString() const {
+        std::string text = "B";
+        for (unsigned int n = 0; n < NEIGHBOUR_COUNTS; ++n) {
+            if ((birth >> n) & 1u) text += static_cast<char>('0' + n);
+        }
+        text += "/S";
+        for (unsigned int n = 0; n < NEIGHBOUR_COUNTS; ++n) {
+            if ((survival >> n) & 1u) text += static_cast<char>('0' + n);
+        }
+        return text;
+    }
+
+    // Accepts "B3/S23" (case-insensitive, either order) and the older "23/3"
+    // survival/birth form. Returns false on anything else.
+    static bool parse(const std::string& text, LifeRule& rule) {
+        return parse(text.data(), text.size(), rule);
+    }
+
+    static constexpr bool parse(const char* text, size_t length, LifeRule& rule) {
+        LifeRule parsed;
+        parsed.birth = 0;
+        parsed.survival = 0;
+        size_t slash = length;
+        for (size_t i = 0; i < length; ++i) {
+            if (text[i] != '/') continue;
+            if (slash != length) return false;
+            slash = i;
+        }
+        if (slash == length) return false;
+
+        const size_t begins[2] = {0, slash + 1};
+        const size_t ends[2] = {slash, length};
+        bool sawBirth = false;
+        bool sawSurvival = false;
+        for (int i = 0; i < 2; ++i) {
+            size_t begin = begins[i];
+            char tag = begin < ends[i] ? static_cast<char>(text[begin] | 0x20) : '\0';
+            bool tagged = tag == 'b' || tag == 's';
+            // Untagged digits follow the S/B order of the older notation
+            bool isBirth = tagged ? tag == 'b' : i == 1;
+            if ((isBirth && sawBirth) || (!isBirth && sawSurvival)) return false;
+            (isBirth ? sawBirth : sawSurvival) = true;
+
+            uint16_t& mask = isBirth ? parsed.birth : parsed.survival;
+            for (size_t c = tagged ? begin + 1 : begin; c < ends[i]; ++c) {
+                if (text[c] < '0' || text[c] > '8') return false;
+                mask |= static_cast<uint16_t>(1u << (text[c] - '0'));
+            }
+        }
+
+        rule = parsed;
+        return true;
+    }
+
+    // For rule literals; an invalid string fails to compile when evaluated
+    // as a constant, and throws std::invalid_argument at run time
+    template <size_t N>
+    static constexpr LifeRule fromString(const char (&text)[N]) {
+        LifeRule rule;
+        if (!parse(text, N - 1, rule)) {
+            throw std::invalid_argument("Invalid Life-like rule");
+        }
+        return rule;
+    }
+};
+
+#endif // LIFERULE_HPP
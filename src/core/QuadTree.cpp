@@ -0,0 +1,214 @@
+#include "QuadTree.hpp"
+#include "Grid.hpp"
+#include "BitOps.hpp"
+#include <algorithm>
+
+bool QuadTree::NodeKey::operator==(const NodeKey& other) const {
+    return level == other.level && children[0] == other.children[0] && children[1] == other.children[1] &&
+           children[2] == other.children[2] && children[3] == other.children[3];
+}
+
+size_t QuadTree::NodeKeyHash::operator()(const NodeKey& key) const {
+    uint64_t hash = key.level;
+    for (uint32_t child : key.children) {
+        hash = (hash ^ child) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    return static_cast<size_t>(hash);
+}
+
+QuadTree::QuadTree() {
+    clear();
+}
+
+void QuadTree::clear() {
+    nodes.clear();
+    leafIndex.clear();
+    nodeIndex.clear();
+    nodes.push_back(Node{0, {EMPTY, EMPTY, EMPTY, EMPTY}, 0, 0});
+    root = EMPTY;
+    rootLevel = LEAF_LEVEL;
+}
+
+uint32_t QuadTree::leaf(uint64_t bits) {
+    if (bits == 0) return EMPTY;
+
+    auto it = leafIndex.find(bits);
+    if (it != leafIndex.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{LEAF_LEVEL, {EMPTY, EMPTY, EMPTY, EMPTY}, bits,
+                         static_cast<uint64_t>(bitops::popcount(bits))});
+    leafIndex.emplace(bits, id);
+    return id;
+}
+
+uint32_t QuadTree::node(unsigned int level, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    if (nw == EMPTY && ne == EMPTY && sw == EMPTY && se == EMPTY) return EMPTY;
+
+    NodeKey key{level, {nw, ne, sw, se}};
+    auto it = nodeIndex.find(key);
+    if (it != nodeIndex.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(nodes.size());
+    uint64_t population = nodes[nw].population + nodes[ne].population +
+                          nodes[sw].population + nodes[se].population;
+    nodes.push_back(Node{level, {nw, ne, sw, se}, 0, population});
+    nodeIndex.emplace(key, id);
+    return id;
+}
+
+void QuadTree::setRoot(uint32_t id, unsigned int level) {
+    root = id;
+    rootLevel = std::max(level, LEAF_LEVEL);
+}
+
+void QuadTree::buildFromGrid(const Grid& grid) {
+    clear();
+
+    unsigned int level = LEAF_LEVEL;
+    while ((1ULL << level) < std::max(grid.getWidth(), grid.getHeight())) {
+        ++level;
+    }
+
+    setRoot(buildNode(grid, level, 0, 0), level);
+}
+
+uint32_t QuadTree::buildNode(const Grid& grid, unsigned int level, int64_t x, int64_t y) {
+    if (x >= grid.getWidth() || y >= grid.getHeight()) return EMPTY;
+
+    if (level == LEAF_LEVEL) {
+        // x is a multiple of 8, so each leaf row is one byte of a single grid word
+        uint64_t bits = 0;
+        for (unsigned int row = 0; row < LEAF_SIZE && y + row < grid.getHeight(); ++row) {
+            uint64_t word = grid.getRow(static_cast<unsigned int>(y + row))[x / 64];
+            bits |= ((word >> (x % 64)) & 0xFFULL) << (row * LEAF_SIZE);
+        }
+        return leaf(bits);
+    }
+
+    int64_t half = int64_t(1) << (level - 1);
+    uint32_t nw = buildNode(grid, level - 1, x, y);
+    uint32_t ne = buildNode(grid, level - 1, x + half, y);
+    uint32_t sw = buildNode(grid, level - 1, x, y + half);
+    uint32_t se = buildNode(grid, level - 1, x + half, y + half);
+    return node(level, nw, ne, sw, se);
+}
+
+void QuadTree::forEachLeaf(const std::function<void(int64_t, int64_t, uint64_t)>& visit) const {
+    visitLeaves(root, rootLevel, 0, 0, visit);
+}
+
+void QuadTree::visitLeaves(uint32_t id, unsigned int level, int64_t x, int64_t y,
+                           const std::function<void(int64_t, int64_t, uint64_t)>& visit) const {
+    if (id == EMPTY) return;
+
+    const Node& current = nodes[id];
+    if (level == LEAF_LEVEL) {
+        visit(x, y, current.leafBits);
+        return;
+    }
+
+    int64_t half = int64_t(1) << (level - 1);
+    visitLeaves(current.children[0], level - 1, x, y, visit);
+    visitLeaves(current.children[1], level - 1, x + half, y, visit);
+    visitLeaves(current.children[2], level - 1, x, y + half, visit);
+    visitLeaves(current.children[3], level - 1, x + half, y + half, visit);
+}
+
+void QuadTree::flattenInto(Grid& grid, int64_t offsetX, int64_t offsetY) const {
+    flattenNode(grid, root, rootLevel, offsetX, offsetY);
+}
+
+void QuadTree::flattenNode(Grid& grid, uint32_t id, unsigned int level, int64_t x, int64_t y) const {
+    // Subtrees outside the grid's window are skipped whole, so stamping costs
+    // what lands in the grid rather than the area the tree spans
+    const int64_t size = int64_t(1) << level;
+    if (id == EMPTY || x >= grid.getWidth() || y >= grid.getHeight() || x + size <= 0 || y + size <= 0) {
+        return;
+    }
+
+    const Node& current = nodes[id];
+    if (level > LEAF_LEVEL) {
+        int64_t half = size / 2;
+        flattenNode(grid, current.children[0], level - 1, x, y);
+        flattenNode(grid, current.children[1], level - 1, x + half, y);
+        flattenNode(grid, current.children[2], level - 1, x, y + half);
+        flattenNode(grid, current.children[3], level - 1, x + half, y + half);
+        return;
+    }
+
+    for (unsigned int row = 0; row < LEAF_SIZE; ++row) {
+        uint64_t rowBits = (current.leafBits >> (row * LEAF_SIZE)) & 0xFFULL;
+        int64_t gridX = x;
+        int64_t gridY = y + row;
+        if (!rowBits || gridY < 0 || gridY >= grid.getHeight()) {
+            continue;
+        }
+        // Clip a leaf that hangs over the left edge
+        if (gridX < 0) {
+            rowBits >>= -gridX;
+            gridX = 0;
+        }
+        grid.blit(&rowBits, 1, LEAF_SIZE, 1, static_cast<unsigned int>(gridX),
+                  static_cast<unsigned int>(gridY), Grid::BlitMode::Or);
+    }
+}
+
+QuadTree::Bounds QuadTree::getBounds() const {
+    std::unordered_map<uint32_t, Bounds> memo;
+    return nodeBounds(root, rootLevel, memo);
+}
+
+QuadTree::Bounds QuadTree::nodeBounds(uint32_t id, unsigned int level,
+                                      std::unordered_map<uint32_t, Bounds>& memo) const {
+    Bounds bounds{1, 1, 0, 0};
+    if (id == EMPTY) return bounds;
+
+    auto it = memo.find(id);
+    if (it != memo.end()) return it->second;
+
+    const Node& current = nodes[id];
+    if (level == LEAF_LEVEL) {
+        for (unsigned int row = 0; row < LEAF_SIZE; ++row) {
+            uint64_t rowBits = (current.leafBits >> (row * LEAF_SIZE)) & 0xFFULL;
+            if (!rowBits) continue;
+            int64_t first = bitops::countTrailingZeros(rowBits);
+            int64_t last = bitops::highestSetBit(rowBits);
+            if (bounds.empty()) {
+                bounds = Bounds{first, row, last, row};
+            } else {
+                bounds.minX = std::min(bounds.minX, first);
+                bounds.maxX = std::max(bounds.maxX, last);
+                bounds.maxY = row;
+            }
+        }
+    } else {
+        // Bounds are memoized per node, so shared subtrees are measured once
+        int64_t half = int64_t(1) << (level - 1);
+        const int64_t offsets[4][2] = {{0, 0}, {half, 0}, {0, half}, {half, half}};
+        for (int i = 0; i < 4; ++i) {
+            Bounds child = nodeBounds(current.children[i], level - 1, memo);
+            if (child.empty()) continue;
+            child.minX += offsets[i][0];
+            child.maxX += offsets[i][0];
+            child.minY += offsets[i][1];
+            child.maxY += offsets[i][1];
+            if (bounds.empty()) {
+                bounds = child;
+            } else {
+                bounds.minX = std::min(bounds.minX, child.minX);
+                bounds.minY = std::min(bounds.minY, child.minY);
+                bounds.maxX = std::max(bounds.maxX, child.maxX);
+                bounds.maxY = std::max(bounds.maxY, child.maxY);
+            }
+        }
+    }
+
+    memo.emplace(id, bounds);
+    return bounds;
+}
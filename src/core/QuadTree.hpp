@@ -0,0 +1,87 @@
+#ifndef QUADTREE_HPP
+#define QUADTREE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Grid;
+
+// Hash-consed quadtree universe, the canonical form behind the macrocell (.mc)
+// format. Identical subtrees are stored once, so memory grows with the number
+// of distinct nodes rather than with the area of the pattern.
+//
+// A node at level k covers 2^k x 2^k cells; level 3 nodes are 8x8 leaves whose
+// cells are packed row-major into one word (bit y * 8 + x). Node 0 is the empty
+// node of every level.
+class QuadTree {
+public:
+    static constexpr unsigned int LEAF_LEVEL = 3;
+    static constexpr unsigned int LEAF_SIZE = 8;
+    static constexpr uint32_t EMPTY = 0;
+
+    struct Node {
+        unsigned int level;
+        uint32_t children[4]; // nw, ne, sw, se
+        uint64_t leafBits;
+        uint64_t population;
+    };
+
+    struct Bounds {
+        int64_t minX;
+        int64_t minY;
+        int64_t maxX;
+        int64_t maxY;
+        bool empty() const { return minX > maxX; }
+    };
+
+    QuadTree();
+
+    // Canonical node construction: equal arguments always return the same id
+    uint32_t leaf(uint64_t bits);
+    uint32_t node(unsigned int level, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+
+    void clear();
+    void setRoot(uint32_t id, unsigned int level);
+    uint32_t getRoot() const { return root; }
+    unsigned int getRootLevel() const { return rootLevel; }
+    const Node& getNode(uint32_t id) const { return nodes[id]; }
+    size_t getNodeCount() const { return nodes.size(); }
+    uint64_t getPopulation() const { return nodes[root].population; }
+
+    // Conversion to and from flat storage
+    void buildFromGrid(const Grid& grid);
+    Bounds getBounds() const;
+    // Calls visit(x, y, bits) for every non-empty leaf, with coordinates relative
+    // to the root's top-left corner
+    void forEachLeaf(const std::function<void(int64_t, int64_t, uint64_t)>& visit) const;
+    // Stamps the universe into the grid with the root's top-left corner at
+    // (offsetX, offsetY); only nodes overlapping the grid are visited
+    void flattenInto(Grid& grid, int64_t offsetX = 0, int64_t offsetY = 0) const;
+
+private:
+    struct NodeKey {
+        unsigned int level;
+        uint32_t children[4];
+        bool operator==(const NodeKey& other) const;
+    };
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const;
+    };
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, uint32_t> leafIndex;
+    std::unordered_map<NodeKey, uint32_t, NodeKeyHash> nodeIndex;
+    uint32_t root;
+    unsigned int rootLevel;
+
+    uint32_t buildNode(const Grid& grid, unsigned int level, int64_t x, int64_t y);
+    void flattenNode(Grid& grid, uint32_t id, unsigned int level, int64_t x, int64_t y) const;
+    void visitLeaves(uint32_t id, unsigned int level, int64_t x, int64_t y,
+                     const std::function<void(int64_t, int64_t, uint64_t)>& visit) const;
+    Bounds nodeBounds(uint32_t id, unsigned int level, std::unordered_map<uint32_t, Bounds>& memo) const;
+};
+
+#endif // QUADTREE_HPP
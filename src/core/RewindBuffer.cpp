@@ -0,0 +1,180 @@
+#include "RewindBuffer.hpp"
+#include <algorithm>
+#include <utility>
+
+RewindBuffer::RewindBuffer(size_t memoryBudget, unsigned int keyframeInterval)
+    : memoryBudget(memoryBudget), keyframeInterval(std::max(keyframeInterval, 1u)), memoryUsage(0) {
+}
+
+void RewindBuffer::record(const Grid& grid) {
+    uint64_t generation = grid.getGeneration();
+    if (findFrame(recent, generation)) {
+        return;
+    }
+
+    Grid::Snapshot frame = grid.snapshot();
+    if ((keyframes.empty() || generation % keyframeInterval == 0) && !findFrame(keyframes, generation)) {
+        // After a rewind, later keyframes may already exist; keep the order
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), generation,
+                                   [](uint64_t value, const Grid::Snapshot& key) { return value < key.generation; });
+        keyframes.insert(it, frame);
+        retain(frame);
+    }
+    pushRecent(std::move(frame));
+    enforceBudget();
+}
+
+void RewindBuffer::recordEdit(const Grid& grid) {
+    dropFrom(grid.getGeneration());
+
+    Grid::Snapshot frame = grid.snapshot();
+    keyframes.push_back(frame);
+    retain(frame);
+    pushRecent(std::move(frame));
+    enforceBudget();
+}
+
+bool RewindBuffer::restore(uint64_t generation, Grid& grid) {
+    const Grid::Snapshot* held = findFrame(recent, generation);
+    if (!held) {
+        held = findFrame(keyframes, generation);
+    }
+    if (held) {
+        // Tiles the frame shares with the grid are skipped without comparing.
+        // Later frames may hold an edit the board is leaving behind; they are
+        // recorded again as it steps forward.
+        if (!grid.assign(*held)) {
+            return false;
+        }
+        dropFrom(generation + 1);
+        return true;
+    }
+
+    // Nearest keyframe at or before the target
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), generation,
+                               [](uint64_t value, const Grid::Snapshot& frame) { return value < frame.generation; });
+    if (it == keyframes.begin()) {
+        return false;
+    }
+    const Grid::Snapshot keyframe = *(it - 1);
+    if (keyframe.width != grid.getWidth() || keyframe.height != grid.getHeight()) {
+        return false;
+    }
+
+    // Replay on a grid that shares the keyframe's tiles copy-on-write, and
+    // keep the replayed frames so the next steps back need no replay
+    Grid replay(keyframe);
+    std::deque<Grid::Snapshot> replayed;
+    const size_t capacity = recentCapacity(keyframe);
+    while (replay.getGeneration() < generation) {
+        replay.nextGeneration();
+        replayed.push_back(replay.snapshot());
+        if (replayed.size() > capacity) {
+            replayed.pop_front();
+        }
+    }
+
+    Grid::Snapshot result = replay.snapshot();
+    for (const Grid::Snapshot& frame : recent) {
+        release(frame);
+    }
+    recent = std::move(replayed);
+    for (const Grid::Snapshot& frame : recent) {
+        retain(frame);
+    }
+    dropFrom(generation + 1);
+    enforceBudget();
+    return grid.assign(result);
+}
+
+bool RewindBuffer::canRestore(uint64_t generation) const {
+    return findFrame(recent, generation) ||
+           (!keyframes.empty() && keyframes.front().generation <= generation);
+}
+
+uint64_t RewindBuffer::getOldestGeneration() const {
+    uint64_t oldest = UINT64_MAX;
+    if (!keyframes.empty()) oldest = keyframes.front().generation;
+    if (!recent.empty()) oldest = std::min(oldest, recent.front().generation);
+    return oldest;
+}
+
+void RewindBuffer::clear() {
+    keyframes.clear();
+    recent.clear();
+    tileUses.clear();
+    memoryUsage = 0;
+}
+
+size_t RewindBuffer::frameSize(const Grid::Snapshot& frame) {
+    return static_cast<size_t>(frame.wordsPerRow) * frame.height * sizeof(uint64_t);
+}
+
+const Grid::Snapshot* RewindBuffer::findFrame(const std::deque<Grid::Snapshot>& frames, uint64_t generation) {
+    auto it = std::lower_bound(frames.begin(), frames.end(), generation,
+                               [](const Grid::Snapshot& frame, uint64_t value) { return frame.generation < value; });
+    return (it != frames.end() && it->generation == generation) ? &*it : nullptr;
+}
+
+size_t RewindBuffer::recentCapacity(const Grid::Snapshot& frame) const {
+    // The ring may use up to half of the budget; keyframes get the rest
+    size_t bytes = std::max<size_t>(frameSize(frame), 1);
+    return std::max<size_t>(memoryBudget / 2 / bytes, 1);
+}
+
+void RewindBuffer::pushRecent(Grid::Snapshot frame) {
+    // The ring only holds one consecutive run of generations
+    if (!recent.empty() && recent.back().generation + 1 != frame.generation) {
+        for (const Grid::Snapshot& stale : recent) {
+            release(stale);
+        }
+        recent.clear();
+    }
+
+    const size_t capacity = recentCapacity(frame);
+    retain(frame);
+    recent.push_back(std::move(frame));
+    while (recent.size() > capacity) {
+        release(recent.front());
+        recent.pop_front();
+    }
+}
+
+void RewindBuffer::dropFrom(uint64_t generation) {
+    while (!keyframes.empty() && keyframes.back().generation >= generation) {
+        release(keyframes.back());
+        keyframes.pop_back();
+    }
+    while (!recent.empty() && recent.back().generation >= generation) {
+        release(recent.back());
+        recent.pop_back();
+    }
+}
+
+void RewindBuffer::enforceBudget() {
+    // Keep at least one keyframe so the oldest history stays reachable
+    while (keyframes.size() > 1 && memoryUsage > memoryBudget) {
+        release(keyframes.front());
+        keyframes.pop_front();
+    }
+}
+
+void RewindBuffer::retain(const Grid::Snapshot& frame) {
+    for (size_t t = 0; t < frame.tiles.size(); ++t) {
+        TileUse& use = tileUses[frame.tiles[t].get()];
+        if (use.frames++ == 0) {
+            use.bytes = static_cast<size_t>(frame.getTileRows(t)) * frame.wordsPerRow * sizeof(uint64_t);
+            memoryUsage += use.bytes;
+        }
+    }
+}
+
+void RewindBuffer::release(const Grid::Snapshot& frame) {
+    for (const Grid::CellBuffer& tile : frame.tiles) {
+        auto use = tileUses.find(tile.get());
+        if (use != tileUses.end() && --use->second.frames == 0) {
+            memoryUsage -= use->second.bytes;
+            tileUses.erase(use);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef REWINDBUFFER_HPP
+#define REWINDBUFFER_HPP
+
+#include "Grid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+// In-memory history for scrubbing backward. Every KEYFRAME_INTERVAL-th
+// generation is kept as a keyframe, and the most recent generations are
+// kept in full in a ring. Both hold copy-on-write Grid snapshots, so
+// recording costs no copy. Restoring a generation missing from the ring
+// replays forward from the nearest earlier keyframe, and the replayed frames
+// refill the ring, so further backward steps are instant. The oldest
+// keyframes are dropped once the memory budget is spent.
+class RewindBuffer {
+public:
+    explicit RewindBuffer(size_t memoryBudget = DEFAULT_MEMORY_BUDGET,
+                          unsigned int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    // Call after every generation. Nothing newer than the grid is held (edits
+    // and restores drop it), so a generation already held is the one the
+    // board went through and is not recorded twice.
+    void record(const Grid& grid);
+    // Call after an edit: history from the grid's generation onward no longer
+    // matches, so it is dropped and the edited state becomes a keyframe
+    void recordEdit(const Grid& grid);
+
+    // Rewrites `grid` with the state of an earlier generation and forgets
+    // every later one
+    bool restore(uint64_t generation, Grid& grid);
+    bool canRestore(uint64_t generation) const;
+    uint64_t getOldestGeneration() const;
+
+    void clear();
+    // Bytes of distinct tiles held; a tile shared by several frames counts once
+    size_t getMemoryUsage() const { return memoryUsage; }
+
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 128 * 1024 * 1024;
+    static constexpr unsigned int DEFAULT_KEYFRAME_INTERVAL = 64;
+
+private:
+    size_t memoryBudget;
+    unsigned int keyframeInterval;
+    std::deque<Grid::Snapshot> keyframes; // Ascending generations
+    std::deque<Grid::Snapshot> recent;    // Ascending generations
+
+    // Frames holding each tile, so memory use is kept as a running total
+    struct TileUse {
+        size_t frames = 0;
+        size_t bytes = 0;
+    };
+    std::unordered_map<const uint64_t*, TileUse> tileUses;
+    size_t memoryUsage;
+
+    static size_t frameSize(const Grid::Snapshot& frame);
+    static const Grid::Snapshot* findFrame(const std::deque<Grid::Snapshot>& frames, uint64_t generation);
+    size_t recentCapacity(const Grid::Snapshot& frame) const;
+    void pushRecent(Grid::Snapshot frame);
+    void dropFrom(uint64_t generation);
+    void enforceBudget();
+    void retain(const Grid::Snapshot& frame);
+    void release(const Grid::Snapshot& frame);
+};
+
+#endif // REWINDBUFFER_HPP
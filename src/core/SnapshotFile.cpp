@@ -0,0 +1,170 @@
+#include "SnapshotFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GOL_HAVE_MMAP 1
+#endif
+
+namespace {
+
+// Forces the file's data to stable storage before it is renamed into place
+bool syncFile(const std::string& filename) {
+#ifdef GOL_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    (void)filename;
+    return true;
+#endif
+}
+
+} // namespace
+
+bool SnapshotFile::save(const Grid& grid, const std::string& filename) {
+    return save(grid.snapshot(), filename);
+}
+
+bool SnapshotFile::save(const Grid::Snapshot& snapshot, const std::string& filename) {
+    error.clear();
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.width = snapshot.width;
+    header.height = snapshot.height;
+    header.wordsPerRow = snapshot.wordsPerRow;
+    header.boundaryMode = BOUNDARY_DEAD;
+    header.birthMask = LIFE_BIRTH_MASK;
+    header.survivalMask = LIFE_SURVIVAL_MASK;
+    header.generation = snapshot.generation;
+    header.dataOffset = DATA_ALIGNMENT;
+    header.dataSize = static_cast<uint64_t>(header.wordsPerRow) * header.height * sizeof(uint64_t);
+
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open " + tempFilename + " for writing";
+        return false;
+    }
+
+    std::vector<char> padding(header.dataOffset - sizeof(Header), 0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    // Tiles hold consecutive row bands, so writing them in order yields the rows
+    for (size_t t = 0; t < snapshot.tiles.size(); ++t) {
+        file.write(reinterpret_cast<const char*>(snapshot.tiles[t].get()),
+                   static_cast<std::streamsize>(snapshot.getTileRows(t) * header.wordsPerRow * sizeof(uint64_t)));
+    }
+
+    file.close();
+    if (!file || !syncFile(tempFilename)) {
+        error = "Failed writing " + tempFilename;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+        error = "Cannot replace " + filename;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotFile::readHeader(const std::string& filename, Header& header) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header))) {
+        error = "Truncated snapshot header in " + filename;
+        return false;
+    }
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = filename + " is not a snapshot file";
+        return false;
+    }
+    if (header.version != VERSION || header.headerSize != sizeof(Header)) {
+        error = "Unsupported snapshot version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.wordsPerRow != (header.width + 63) / 64 ||
+        header.dataSize != static_cast<uint64_t>(header.wordsPerRow) * header.height * sizeof(uint64_t) ||
+        header.dataOffset % DATA_ALIGNMENT != 0) {
+        error = "Inconsistent snapshot layout in " + filename;
+        return false;
+    }
+    if (header.boundaryMode != BOUNDARY_DEAD || header.birthMask != LIFE_BIRTH_MASK ||
+        header.survivalMask != LIFE_SURVIVAL_MASK) {
+        error = "Snapshot uses a rule or boundary this engine does not support";
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(file.tellg()) < header.dataOffset + header.dataSize) {
+        error = "Truncated snapshot data in " + filename;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Grid> SnapshotFile::load(const std::string& filename) {
+    error.clear();
+
+    Header header;
+    if (!readHeader(filename, header)) {
+        return nullptr;
+    }
+
+    if (header.dataSize == 0) {
+        auto grid = std::make_unique<Grid>(header.width, header.height);
+        grid->setGeneration(header.generation);
+        return grid;
+    }
+
+#ifdef GOL_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open " + filename;
+        return nullptr;
+    }
+
+    size_t mappedSize = static_cast<size_t>(header.dataOffset + header.dataSize);
+    void* base = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        error = "Cannot map " + filename;
+        return nullptr;
+    }
+
+    uint64_t* rows = reinterpret_cast<uint64_t*>(static_cast<char*>(base) + header.dataOffset);
+    Grid::CellBuffer storage(rows, [base, mappedSize](uint64_t*) { ::munmap(base, mappedSize); });
+#else
+    // No mmap: read the rows into a heap buffer instead
+    Grid::CellBuffer storage(new uint64_t[header.dataSize / sizeof(uint64_t)]);
+    std::ifstream file(filename, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(header.dataOffset));
+    if (!file.read(reinterpret_cast<char*>(storage.get()), static_cast<std::streamsize>(header.dataSize))) {
+        error = "Failed reading " + filename;
+        return nullptr;
+    }
+#endif
+
+    return std::make_unique<Grid>(header.width, header.height, std::move(storage), header.generation);
+}
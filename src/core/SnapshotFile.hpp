@@ -0,0 +1,59 @@
+#ifndef SNAPSHOTFILE_HPP
+#define SNAPSHOTFILE_HPP
+
+#include "Grid.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Versioned binary snapshot of a universe. A fixed 64-byte header is followed,
+// at a page-aligned offset, by the grid's packed rows exactly as Grid stores
+// them, so a restore maps the file and adopts the rows as the backing store.
+// Pages are faulted in lazily and the private mapping is copy-on-write, so the
+// file on disk is never modified by the running simulation.
+class SnapshotFile {
+public:
+    static constexpr char MAGIC[8] = {'G', 'O', 'L', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t DATA_ALIGNMENT = 4096;
+
+    // Cells beyond the grid edge are treated as dead
+    static constexpr uint32_t BOUNDARY_DEAD = 0;
+
+    // Outer-totalistic rule as neighbour-count bit masks (bit n = n neighbours)
+    static constexpr uint16_t LIFE_BIRTH_MASK = 1 << 3;
+    static constexpr uint16_t LIFE_SURVIVAL_MASK = (1 << 2) | (1 << 3);
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t width;
+        uint32_t height;
+        uint32_t wordsPerRow;
+        uint32_t boundaryMode;
+        uint16_t birthMask;
+        uint16_t survivalMask;
+        uint32_t reserved;
+        uint64_t generation;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+    static_assert(sizeof(Header) == 64, "Snapshot header must stay 64 bytes");
+
+    // Writes to `filename`.tmp, flushes it to disk and renames it into place,
+    // so a crash mid-write leaves the previous file intact
+    bool save(const Grid& grid, const std::string& filename);
+    bool save(const Grid::Snapshot& snapshot, const std::string& filename);
+    // Returns nullptr on failure; the grid keeps the mapping alive
+    std::unique_ptr<Grid> load(const std::string& filename);
+
+    const std::string& getError() const { return error; }
+
+private:
+    std::string error;
+
+    bool readHeader(const std::string& filename, Header& header);
+};
+
+#endif // SNAPSHOTFILE_HPP
@@ -0,0 +1,92 @@
+#include "UndoJournal.hpp"
+#include <utility>
+
+UndoJournal::UndoJournal(size_t memoryLimit)
+    : pendingGeneration(0), memoryUsage(0), memoryLimit(memoryLimit) {
+}
+
+void UndoJournal::begin(Grid& grid) {
+    pending.clear();
+    pendingGeneration = grid.getGeneration();
+    grid.setDeltaSink(&pending);
+}
+
+void UndoJournal::commit(Grid& grid, Action action, uint64_t group) {
+    grid.setDeltaSink(nullptr);
+    if (pending.empty() && grid.getGeneration() == pendingGeneration) {
+        return; // Nothing changed
+    }
+
+    // A new change invalidates everything that could be redone
+    clearRedo();
+
+    if (group != 0 && !undoStack.empty() && undoStack.back().group == group &&
+        undoStack.back().action == action) {
+        Entry& last = undoStack.back();
+        memoryUsage -= last.memorySize();
+        last.deltas.insert(last.deltas.end(), pending.begin(), pending.end());
+        last.generationAfter = grid.getGeneration();
+        memoryUsage += last.memorySize();
+    } else {
+        Entry entry{action, group, pendingGeneration, grid.getGeneration(),
+                    std::vector<Grid::WordDelta>(pending.begin(), pending.end())};
+        memoryUsage += entry.memorySize();
+        undoStack.push_back(std::move(entry));
+    }
+
+    pending.clear();
+    enforceLimit();
+}
+
+bool UndoJournal::undo(Grid& grid) {
+    if (undoStack.empty()) return false;
+
+    Entry entry = std::move(undoStack.back());
+    undoStack.pop_back();
+
+    // XOR deltas are their own inverse
+    grid.applyDelta(entry.deltas);
+    grid.setGeneration(entry.generationBefore);
+
+    redoStack.push_back(std::move(entry));
+    return true;
+}
+
+bool UndoJournal::redo(Grid& grid) {
+    if (redoStack.empty()) return false;
+
+    Entry entry = std::move(redoStack.back());
+    redoStack.pop_back();
+
+    grid.applyDelta(entry.deltas);
+    grid.setGeneration(entry.generationAfter);
+
+    undoStack.push_back(std::move(entry));
+    return true;
+}
+
+void UndoJournal::clear() {
+    undoStack.clear();
+    redoStack.clear();
+    pending.clear();
+    memoryUsage = 0;
+}
+
+void UndoJournal::setMemoryLimit(size_t limit) {
+    memoryLimit = limit;
+    enforceLimit();
+}
+
+void UndoJournal::clearRedo() {
+    for (const Entry& entry : redoStack) {
+        memoryUsage -= entry.memorySize();
+    }
+    redoStack.clear();
+}
+
+void UndoJournal::enforceLimit() {
+    while (memoryUsage > memoryLimit && !undoStack.empty()) {
+        memoryUsage -= undoStack.front().memorySize();
+        undoStack.pop_front();
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef UNDOJOURNAL_HPP
+#define UNDOJOURNAL_HPP
+
+#include "Grid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Undo/redo history of grid edits and generation steps. Each entry keeps
+// only the XOR deltas of the words it changed (captured through
+// Grid::setDeltaSink), so undoing costs time and memory proportional to the
+// change, not to the grid. The oldest entries are dropped once the history
+// exceeds its memory limit.
+class UndoJournal {
+public:
+    enum class Action {
+        Edit,   // Painting, pattern placement, clearing
+        Step    // One generation
+    };
+
+    explicit UndoJournal(size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+    // Bracket one undoable change: begin() starts capturing into a pending
+    // entry, commit() files it. Commits with the same non-zero group as the
+    // newest entry are merged into it (e.g. one entry per paint stroke).
+    void begin(Grid& grid);
+    void commit(Grid& grid, Action action, uint64_t group = 0);
+
+    bool undo(Grid& grid);
+    bool redo(Grid& grid);
+    bool canUndo() const { return !undoStack.empty(); }
+    bool canRedo() const { return !redoStack.empty(); }
+    void clear();
+
+    size_t getMemoryUsage() const { return memoryUsage; }
+    size_t getMemoryLimit() const { return memoryLimit; }
+    void setMemoryLimit(size_t limit);
+
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+private:
+    struct Entry {
+        Action action;
+        uint64_t group;
+        uint64_t generationBefore;
+        uint64_t generationAfter;
+        std::vector<Grid::WordDelta> deltas;
+
+        size_t memorySize() const { return sizeof(Entry) + deltas.capacity() * sizeof(Grid::WordDelta); }
+    };
+
+    std::deque<Entry> undoStack; // Newest at the back
+    std::vector<Entry> redoStack;
+    std::vector<Grid::WordDelta> pending;
+    uint64_t pendingGeneration;
+    size_t memoryUsage;
+    size_t memoryLimit;
+
+    void clearRedo();
+    void enforceLimit();
+};
+
+#endif // UNDOJOURNAL_HPP
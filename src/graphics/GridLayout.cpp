@@ -0,0 +1,59 @@
+#include "GridLayout.hpp"
+#include <algorithm>
+#include <cmath>
+
+GridLayout GridLayout::compute(sf::Vector2u windowSize, unsigned int columns, unsigned int rows) {
+    GridLayout layout;
+    layout.windowSize = windowSize;
+    layout.columns = columns;
+    layout.rows = rows;
+
+    float availableWidth = windowSize.x - (2 * MARGIN);
+    float availableHeight = windowSize.y - (2 * MARGIN) - BUTTON_HEIGHT - BUTTON_SPACING;
+
+    availableWidth = std::max(availableWidth, MIN_AVAILABLE_SIZE);
+    availableHeight = std::max(availableHeight, MIN_AVAILABLE_SIZE);
+
+    if (columns > 0 && rows > 0) {
+        float maxCellWidth = availableWidth / columns;
+        float maxCellHeight = availableHeight / rows;
+        layout.cellSize = std::max(1.0f, std::min(maxCellWidth, maxCellHeight));
+    }
+
+    float gridWidth = layout.cellSize * columns;
+    float gridHeight = layout.cellSize * rows;
+
+    float offsetX = MARGIN + (availableWidth - gridWidth) / 2.0f;
+    float offsetY = MARGIN + BUTTON_HEIGHT + BUTTON_SPACING + (availableHeight - gridHeight) / 2.0f;
+
+    layout.offset.x = std::max(MARGIN, offsetX);
+    layout.offset.y = std::max(MARGIN + BUTTON_HEIGHT + BUTTON_SPACING, offsetY);
+
+    return layout;
+}
+
+std::pair<int, int> GridLayout::screenToGrid(const sf::Vector2i& screenPos) const {
+    sf::Vector2i cell = screenToCell(screenPos);
+    int gridX = cell.x;
+    int gridY = cell.y;
+
+    if (gridX < 0 || gridY < 0 || gridX >= static_cast<int>(columns) ||
+        gridY >= static_cast<int>(rows)) {
+        return std::make_pair(-1, -1);
+    }
+
+    return std::make_pair(gridX, gridY);
+}
+
+sf::Vector2i GridLayout::screenToCell(const sf::Vector2i& screenPos) const {
+    return sf::Vector2i(static_cast<int>(std::floor((screenPos.x - offset.x) / cellSize)),
+                        static_cast<int>(std::floor((screenPos.y - offset.y) / cellSize)));
+}
+
+sf::Vector2f GridLayout::cellPosition(unsigned int x, unsigned int y) const {
+    return sf::Vector2f(offset.x + x * cellSize, offset.y + y * cellSize);
+}
+
+sf::Vector2f GridLayout::gridDimensions() const {
+    return sf::Vector2f(cellSize * columns, cellSize * rows);
+}
@@ -0,0 +1,32 @@
+#ifndef GRIDLAYOUT_HPP
+#define GRIDLAYOUT_HPP
+
+#include <SFML/Graphics.hpp>
+#include <utility>
+
+// Screen-space placement of the grid. Computed once per resize and shared by
+// rendering and hit-testing so neither redoes the layout math per frame.
+struct GridLayout {
+    sf::Vector2u windowSize;
+    sf::Vector2f offset;
+    float cellSize = 1.0f;
+    unsigned int columns = 0;
+    unsigned int rows = 0;
+
+    static GridLayout compute(sf::Vector2u windowSize, unsigned int columns, unsigned int rows);
+
+    // Returns (-1, -1) when the position falls outside the grid
+    std::pair<int, int> screenToGrid(const sf::Vector2i& screenPos) const;
+    // Unclamped cell coordinates, which may lie outside the grid
+    sf::Vector2i screenToCell(const sf::Vector2i& screenPos) const;
+    sf::Vector2f cellPosition(unsigned int x, unsigned int y) const;
+    sf::Vector2f gridDimensions() const;
+
+    // Layout constants
+    static constexpr float MARGIN = 60.0f;
+    static constexpr float BUTTON_HEIGHT = 40.0f;
+    static constexpr float BUTTON_SPACING = 10.0f;
+    static constexpr float MIN_AVAILABLE_SIZE = 100.0f;
+};
+
+#endif // GRIDLAYOUT_HPP
@@ -1,17 +1,24 @@
 #include "Renderer.hpp"
 #include "../core/Grid.hpp"
 #include "../ui/UIManager.hpp"
+#include "../core/BitOps.hpp"
 #include <algorithm>
 
 Renderer::Renderer(sf::RenderWindow& window)
-    : window(window), showGrid(true) {
+    : window(window), showGrid(true), layoutVersion(0),
+      backgroundBuffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static),
+      cellBuffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic),
+      useVertexBuffers(sf::VertexBuffer::isAvailable()),
+      meshLayoutVersion(0) {
 }
 
 void Renderer::render(const Grid& grid, const UIManager& uiManager) {
+    syncCellMesh(grid);
+
     clear();
     renderBackground();
     renderGridBorder();
-    renderCells(grid);
+    renderCells();
     renderUI(uiManager);
     display();
 }
@@ -24,110 +31,151 @@ void Renderer::display() {
     window.display();
 }
 
-sf::Vector2f Renderer::calculateGridOffset() const {
+bool Renderer::updateLayout(const Grid& grid) {
     sf::Vector2u windowSize = window.getSize();
+    unsigned int visibleWidth = std::min(grid.getWidth(), GRID_WIDTH);
+    unsigned int visibleHeight = std::min(grid.getHeight(), GRID_HEIGHT);
 
-    float availableWidth = windowSize.x - (2 * MARGIN);
-    float availableHeight = windowSize.y - (2 * MARGIN) - BUTTON_HEIGHT - BUTTON_SPACING;
-
-    availableWidth = std::max(availableWidth, 100.0f);
-    availableHeight = std::max(availableHeight, 100.0f);
+    if (layoutVersion > 0 && windowSize == layout.windowSize &&
+        visibleWidth == layout.columns && visibleHeight == layout.rows) {
+        return false;
+    }
 
-    float cellSize = calculateCellSize();
-    float gridWidth = cellSize * GRID_WIDTH;
-    float gridHeight = cellSize * GRID_HEIGHT;
+    layout = GridLayout::compute(windowSize, visibleWidth, visibleHeight);
+    ++layoutVersion;
+    return true;
+}
 
-    float offsetX = MARGIN + (availableWidth - gridWidth) / 2.0f;
-    float offsetY = MARGIN + BUTTON_HEIGHT + BUTTON_SPACING + (availableHeight - gridHeight) / 2.0f;
+std::pair<int, int> Renderer::screenToGrid(const sf::Vector2i& screenPos) const {
+    return layout.screenToGrid(screenPos);
+}
 
-    offsetX = std::max(MARGIN, offsetX);
-    offsetY = std::max(MARGIN + BUTTON_HEIGHT + BUTTON_SPACING, offsetY);
+void Renderer::renderBackground() const {
+    if (!showGrid || backgroundVertices.empty()) return;
 
-    return sf::Vector2f(offsetX, offsetY);
+    if (useVertexBuffers) {
+        window.draw(backgroundBuffer);
+    } else {
+        window.draw(backgroundVertices.data(), backgroundVertices.size(), sf::PrimitiveType::Triangles);
+    }
 }
 
-float Renderer::calculateCellSize() const {
-    sf::Vector2u windowSize = window.getSize();
+void Renderer::renderGridBorder() const {
+    sf::RectangleShape outerBorder(layout.gridDimensions());
+    outerBorder.setPosition(layout.offset);
+    outerBorder.setOutlineThickness(3.0f);
+    outerBorder.setOutlineColor(sf::Color(200, 200, 200));
+    outerBorder.setFillColor(sf::Color::Transparent);
+    window.draw(outerBorder);
+}
 
-    float availableWidth = windowSize.x - (2 * MARGIN);
-    float availableHeight = windowSize.y - (2 * MARGIN) - BUTTON_HEIGHT - BUTTON_SPACING;
+void Renderer::renderCells() const {
+    if (cellVertices.empty()) return;
 
-    availableWidth = std::max(availableWidth, 100.0f);
-    availableHeight = std::max(availableHeight, 100.0f);
+    if (useVertexBuffers) {
+        window.draw(cellBuffer);
+    } else {
+        window.draw(cellVertices.data(), cellVertices.size(), sf::PrimitiveType::Triangles);
+    }
+}
 
-    float maxCellWidth = availableWidth / GRID_WIDTH;
-    float maxCellHeight = availableHeight / GRID_HEIGHT;
+void Renderer::syncCellMesh(const Grid& grid) {
+    updateLayout(grid);
 
-    return std::max(1.0f, std::min(maxCellWidth, maxCellHeight));
+    if (meshLayoutVersion != layoutVersion) {
+        meshLayoutVersion = layoutVersion;
+        rebuildMeshes(grid);
+    } else if (grid.hasChanges()) {
+        patchChangedCells(grid);
+    }
 }
 
-std::pair<int, int> Renderer::screenToGrid(const sf::Vector2i& screenPos) const {
-    sf::Vector2f gridOffset = calculateGridOffset();
-    float cellSize = calculateCellSize();
+void Renderer::rebuildMeshes(const Grid& grid) {
+    const unsigned int meshWidth = layout.columns;
+    const unsigned int meshHeight = layout.rows;
+    const float cellSize = layout.cellSize;
+    const float cellPadding = cellSize * 0.1f;
+    const float liveCellSize = cellSize - (cellPadding * 2);
+
+    size_t vertexCount = static_cast<size_t>(meshWidth) * meshHeight * 6;
+    backgroundVertices.resize(vertexCount);
+    cellVertices.resize(vertexCount);
 
-    int gridX = static_cast<int>((screenPos.x - gridOffset.x) / cellSize);
-    int gridY = static_cast<int>((screenPos.y - gridOffset.y) / cellSize);
+    for (unsigned int y = 0; y < meshHeight; ++y) {
+        for (unsigned int x = 0; x < meshWidth; ++x) {
+            size_t index = static_cast<size_t>(y) * meshWidth + x;
+            sf::Vector2f cellPosition = layout.cellPosition(x, y);
 
-    if (gridX < 0 || gridY < 0 || gridX >= static_cast<int>(GRID_WIDTH) ||
-        gridY >= static_cast<int>(GRID_HEIGHT)) {
-        return std::make_pair(-1, -1);
+            setQuad(backgroundVertices, index, cellPosition, cellSize, getBackgroundColor(x, y));
+            setQuad(cellVertices, index,
+                    sf::Vector2f(cellPosition.x + cellPadding, cellPosition.y + cellPadding),
+                    liveCellSize, grid.getCell(x, y) ? sf::Color::Black : sf::Color::Transparent);
+        }
     }
 
-    return std::make_pair(gridX, gridY);
+    if (useVertexBuffers) {
+        useVertexBuffers = backgroundBuffer.create(vertexCount) && cellBuffer.create(vertexCount) &&
+                           backgroundBuffer.update(backgroundVertices.data()) &&
+                           cellBuffer.update(cellVertices.data());
+    }
 }
 
-void Renderer::renderBackground() const {
-    if (!showGrid) return;
-
-    sf::Vector2f gridOffset = calculateGridOffset();
-    float cellSize = calculateCellSize();
-
-    for (unsigned int y = 0; y < GRID_HEIGHT; ++y) {
-        for (unsigned int x = 0; x < GRID_WIDTH; ++x) {
-            sf::RectangleShape backgroundCell(sf::Vector2f(cellSize, cellSize));
-            backgroundCell.setPosition(sf::Vector2f(
-                gridOffset.x + x * cellSize,
-                gridOffset.y + y * cellSize
-            ));
-            backgroundCell.setFillColor(getBackgroundColor(x, y));
-            window.draw(backgroundCell);
+void Renderer::patchChangedCells(const Grid& grid) {
+    // Only rows flagged in the change mask are touched, and within them only the
+    // flipped bits, so the per-frame cost follows the churn rather than the area
+    const unsigned int meshWidth = layout.columns;
+    const unsigned int meshHeight = layout.rows;
+
+    for (unsigned int y = grid.getChangedTop(); y <= grid.getChangedBottom() && y < meshHeight; ++y) {
+        if (!grid.isRowChanged(y)) continue;
+
+        const uint64_t* row = grid.getRow(y);
+        const uint64_t* changed = grid.getChangedRow(y);
+        unsigned int firstX = meshWidth;
+        unsigned int lastX = 0;
+
+        for (unsigned int i = 0; i < grid.getWordsPerRow() && i * 64 < meshWidth; ++i) {
+            uint64_t flipped = changed[i];
+            while (flipped) {
+                unsigned int x = i * 64 + bitops::countTrailingZeros(flipped);
+                flipped &= flipped - 1;
+                if (x >= meshWidth) break;
+
+                bool alive = (row[i] >> (x % 64)) & 1ULL;
+                setQuadColor(cellVertices, static_cast<size_t>(y) * meshWidth + x,
+                             alive ? sf::Color::Black : sf::Color::Transparent);
+                firstX = std::min(firstX, x);
+                lastX = std::max(lastX, x);
+            }
+        }
+
+        if (useVertexBuffers && firstX <= lastX) {
+            size_t first = (static_cast<size_t>(y) * meshWidth + firstX) * 6;
+            size_t count = static_cast<size_t>(lastX - firstX + 1) * 6;
+            cellBuffer.update(&cellVertices[first], count, static_cast<unsigned int>(first));
         }
     }
 }
 
-void Renderer::renderGridBorder() const {
-    sf::Vector2f gridOffset = calculateGridOffset();
-    sf::Vector2f gridDimensions = getGridDimensions();
-
-    sf::RectangleShape outerBorder(gridDimensions);
-    outerBorder.setPosition(gridOffset);
-    outerBorder.setOutlineThickness(3.0f);
-    outerBorder.setOutlineColor(sf::Color(200, 200, 200));
-    outerBorder.setFillColor(sf::Color::Transparent);
-    window.draw(outerBorder);
+void Renderer::setQuad(std::vector<sf::Vertex>& vertices, size_t index, sf::Vector2f position,
+                       float size, sf::Color color) const {
+    sf::Vertex* quad = &vertices[index * 6];
+    sf::Vector2f topRight(position.x + size, position.y);
+    sf::Vector2f bottomLeft(position.x, position.y + size);
+    sf::Vector2f bottomRight(position.x + size, position.y + size);
+
+    quad[0].position = position;
+    quad[1].position = topRight;
+    quad[2].position = bottomLeft;
+    quad[3].position = bottomLeft;
+    quad[4].position = topRight;
+    quad[5].position = bottomRight;
+    setQuadColor(vertices, index, color);
 }
 
-void Renderer::renderCells(const Grid& grid) const {
-    sf::Vector2f gridOffset = calculateGridOffset();
-    float cellSize = calculateCellSize();
-
-    const float cellPadding = cellSize * 0.1f;
-    const float liveCellSize = cellSize - (cellPadding * 2);
-
-    //const auto& cells = grid.getCells();
-
-    for (unsigned int y = 0; y < grid.getHeight() && y < GRID_HEIGHT; ++y) {
-        for (unsigned int x = 0; x < grid.getWidth() && x < GRID_WIDTH; ++x) {
-            if (grid.getCell(x, y)) {
-                sf::RectangleShape liveCell(sf::Vector2f(liveCellSize, liveCellSize));
-                liveCell.setPosition(sf::Vector2f(
-                    gridOffset.x + x * cellSize + cellPadding,
-                    gridOffset.y + y * cellSize + cellPadding
-                ));
-                liveCell.setFillColor(sf::Color::Black);
-                window.draw(liveCell);
-            }
-        }
+void Renderer::setQuadColor(std::vector<sf::Vertex>& vertices, size_t index, sf::Color color) const {
+    for (size_t i = 0; i < 6; ++i) {
+        vertices[index * 6 + i].color = color;
     }
 }
 
@@ -135,11 +183,6 @@ void Renderer::renderUI(const UIManager& uiManager) const {
     uiManager.draw(window);
 }
 
-sf::Vector2f Renderer::getGridDimensions() const {
-    float cellSize = calculateCellSize();
-    return sf::Vector2f(cellSize * GRID_WIDTH, cellSize * GRID_HEIGHT);
-}
-
 sf::Color Renderer::getBackgroundColor(unsigned int x, unsigned int y) const {
     if ((x + y) % 2 == 0) {
         return sf::Color(245, 245, 245);
@@ -1,7 +1,9 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include "GridLayout.hpp"
 #include <SFML/Graphics.hpp>
+#include <vector>
 
 // Forward declarations
 class Grid;
@@ -16,34 +18,51 @@ public:
     void clear();
     void display();
 
-    // Layout calculations
-    sf::Vector2f calculateGridOffset() const;
-    float calculateCellSize() const;
+    // Layout (recomputed only when the window or visible grid size changes)
+    bool updateLayout(const Grid& grid);
+    const GridLayout& getLayout() const { return layout; }
     std::pair<int, int> screenToGrid(const sf::Vector2i& screenPos) const;
+    // Forces a full mesh rebuild, e.g. after the grid object was replaced
+    void invalidateMesh() { meshLayoutVersion = 0; }
 
     // Grid rendering settings
     void setGridVisible(bool visible) { showGrid = visible; }
     bool isGridVisible() const { return showGrid; }
 
     // Constants
-    static constexpr float MARGIN = 60.0f;
-    static constexpr float BUTTON_HEIGHT = 40.0f;
-    static constexpr float BUTTON_SPACING = 10.0f;
     static constexpr unsigned int GRID_WIDTH = 60;
     static constexpr unsigned int GRID_HEIGHT = 40;
 
 private:
     sf::RenderWindow& window;
     bool showGrid;
+    GridLayout layout;
+    unsigned int layoutVersion;
+
+    // Persistent geometry: one quad (6 vertices) per cell, rebuilt only when the
+    // layout changes and otherwise patched from the grid's change mask
+    std::vector<sf::Vertex> backgroundVertices;
+    std::vector<sf::Vertex> cellVertices;
+    sf::VertexBuffer backgroundBuffer;
+    sf::VertexBuffer cellBuffer;
+    bool useVertexBuffers;
+    unsigned int meshLayoutVersion;
 
     // Rendering methods
     void renderBackground() const;
     void renderGridBorder() const;
-    void renderCells(const Grid& grid) const;
+    void renderCells() const;
     void renderUI(const UIManager& uiManager) const;
 
+    // Cell mesh maintenance
+    void syncCellMesh(const Grid& grid);
+    void rebuildMeshes(const Grid& grid);
+    void patchChangedCells(const Grid& grid);
+    void setQuad(std::vector<sf::Vertex>& vertices, size_t index, sf::Vector2f position,
+                 float size, sf::Color color) const;
+    void setQuadColor(std::vector<sf::Vertex>& vertices, size_t index, sf::Color color) const;
+
     // Helper methods
-    sf::Vector2f getGridDimensions() const;
     sf::Color getBackgroundColor(unsigned int x, unsigned int y) const;
 };
 
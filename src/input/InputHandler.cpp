@@ -3,9 +3,10 @@
 #include "../core/Grid.hpp"
 #include "../ui/UIManager.hpp"
 #include "../graphics/Renderer.hpp"
+#include <cstdlib>
 
 InputHandler::InputHandler(GameEngine& gameEngine)
-    : gameEngine(gameEngine), isMousePressed(false) {
+    : gameEngine(gameEngine), isMousePressed(false), isPainting(false), paintValue(true), paintStroke(0) {
 }
 
 void InputHandler::processEvents() {
@@ -17,10 +18,12 @@ void InputHandler::processEvents() {
         handleMouseEvents(*event);
         handleKeyboardEvents(*event);
     }
+
+    flushPaint();
 }
 
-void InputHandler::setOnCellToggle(std::function<void(int, int)> callback) {
-    onCellToggle = callback;
+void InputHandler::setOnCellsPaint(std::function<void(const std::vector<std::pair<unsigned int, unsigned int>>&, bool)> callback) {
+    onCellsPaint = callback;
 }
 
 void InputHandler::setOnPauseToggle(std::function<void()> callback) {
@@ -39,6 +42,30 @@ void InputHandler::setOnGridClear(std::function<void()> callback) {
     onGridClear = callback;
 }
 
+void InputHandler::setOnSnapshotSave(std::function<void()> callback) {
+    onSnapshotSave = callback;
+}
+
+void InputHandler::setOnSnapshotLoad(std::function<void()> callback) {
+    onSnapshotLoad = callback;
+}
+
+void InputHandler::setOnUndo(std::function<void()> callback) {
+    onUndo = callback;
+}
+
+void InputHandler::setOnRedo(std::function<void()> callback) {
+    onRedo = callback;
+}
+
+void InputHandler::setOnStepBackward(std::function<void()> callback) {
+    onStepBackward = callback;
+}
+
+void InputHandler::setOnCensus(std::function<void()> callback) {
+    onCensus = callback;
+}
+
 void InputHandler::handleWindowEvents(const sf::Event& event) {
     if (event.is<sf::Event::Closed>()) {
         handleWindowClose();
@@ -60,6 +87,7 @@ void InputHandler::handleMouseEvents(const sf::Event& event) {
         auto mouseEvent = event.getIf<sf::Event::MouseButtonReleased>();
         if (mouseEvent->button == sf::Mouse::Button::Left) {
             isMousePressed = false;
+            endPaintStroke();
         }
     } else if (event.is<sf::Event::MouseMoved>()) {
         auto moveEvent = event.getIf<sf::Event::MouseMoved>();
@@ -72,7 +100,9 @@ void InputHandler::handleMouseEvents(const sf::Event& event) {
 void InputHandler::handleKeyboardEvents(const sf::Event& event) {
     if (event.is<sf::Event::KeyPressed>()) {
         auto keyEvent = event.getIf<sf::Event::KeyPressed>();
-        handleKeyPress(keyEvent->code);
+        if (!keyEvent->control || !handleControlShortcut(keyEvent->code, keyEvent->shift)) {
+            handleKeyPress(keyEvent->code);
+        }
     }
 }
 
@@ -83,58 +113,90 @@ void InputHandler::handleMouseClick(const sf::Vector2i& mousePos) {
         return; // UI handled the click
     }
     
-    // Then check if grid cell was clicked
-    // We need to get the renderer to convert screen to grid coordinates
-    // For now, we'll implement a basic version - this should be improved
-    // to use the Renderer's screenToGrid method
-    if (onCellToggle) {
-        // This is a simplified version - in a full implementation,
-        // we'd get the Renderer instance and use its screenToGrid method
-        Grid& grid = gameEngine.getGrid();
-        
-        // Basic coordinate conversion (this should use Renderer::screenToGrid)
-        sf::RenderWindow& window = gameEngine.getWindow();
-        sf::Vector2u windowSize = window.getSize();
-        
-        // Simplified calculation - should be moved to Renderer
-        const float MARGIN = 60.0f;
-        const float BUTTON_HEIGHT = 40.0f;
-        const float BUTTON_SPACING = 10.0f;
-        const unsigned int GRID_WIDTH = 60;
-        const unsigned int GRID_HEIGHT = 40;
-        
-        float availableWidth = windowSize.x - (2 * MARGIN);
-        float availableHeight = windowSize.y - (2 * MARGIN) - BUTTON_HEIGHT - BUTTON_SPACING;
-        
-        availableWidth = std::max(availableWidth, 100.0f);
-        availableHeight = std::max(availableHeight, 100.0f);
-        
-        float maxCellWidth = availableWidth / GRID_WIDTH;
-        float maxCellHeight = availableHeight / GRID_HEIGHT;
-        float cellSize = std::max(1.0f, std::min(maxCellWidth, maxCellHeight));
-        
-        float gridWidth = cellSize * GRID_WIDTH;
-        float gridHeight = cellSize * GRID_HEIGHT;
-        
-        float offsetX = MARGIN + (availableWidth - gridWidth) / 2.0f;
-        float offsetY = MARGIN + BUTTON_HEIGHT + BUTTON_SPACING + (availableHeight - gridHeight) / 2.0f;
-        
-        offsetX = std::max(MARGIN, offsetX);
-        offsetY = std::max(MARGIN + BUTTON_HEIGHT + BUTTON_SPACING, offsetY);
-        
-        int gridX = static_cast<int>((mousePos.x - offsetX) / cellSize);
-        int gridY = static_cast<int>((mousePos.y - offsetY) / cellSize);
-        
-        if (gridX >= 0 && gridY >= 0 && gridX < static_cast<int>(GRID_WIDTH) && 
-            gridY < static_cast<int>(GRID_HEIGHT)) {
-            onCellToggle(gridX, gridY);
-        }
-    }
+    // Then start a paint stroke if a grid cell was clicked
+    beginPaintStroke(mousePos);
 }
 
 void InputHandler::handleMouseMove(const sf::Vector2i& mousePos) {
     UIManager& uiManager = gameEngine.getUIManager();
     uiManager.updateHover(mousePos);
+
+    if (isMousePressed && isPainting) {
+        continuePaintStroke(mousePos);
+    }
+}
+
+void InputHandler::beginPaintStroke(const sf::Vector2i& mousePos) {
+    auto cell = gameEngine.getRenderer().screenToGrid(mousePos);
+    if (!onCellsPaint || cell.first < 0 || cell.second < 0) {
+        return;
+    }
+
+    // A stroke that ended earlier in this frame is applied with its own value
+    endPaintStroke();
+
+    // The stroke paints the opposite of the first cell's state, so a plain
+    // click still toggles exactly that cell
+    paintValue = !gameEngine.getGrid().getCell(cell.first, cell.second);
+    isPainting = true;
+    ++paintStroke;
+    lastPaintCell = sf::Vector2i(cell.first, cell.second);
+    pendingPaint.emplace_back(cell.first, cell.second);
+}
+
+void InputHandler::continuePaintStroke(const sf::Vector2i& mousePos) {
+    sf::Vector2i cell = gameEngine.getRenderer().getLayout().screenToCell(mousePos);
+    if (cell == lastPaintCell) {
+        return;
+    }
+
+    rasterizeSegment(lastPaintCell, cell);
+    lastPaintCell = cell;
+}
+
+void InputHandler::endPaintStroke() {
+    flushPaint();
+    isPainting = false;
+}
+
+void InputHandler::rasterizeSegment(sf::Vector2i from, sf::Vector2i to) {
+    // Bresenham from `from` (already painted) to `to`, so fast strokes leave no gaps.
+    // Unclamped coordinates keep the line straight when it leaves the grid.
+    const GridLayout& layout = gameEngine.getRenderer().getLayout();
+    int dx = std::abs(to.x - from.x);
+    int dy = -std::abs(to.y - from.y);
+    int stepX = from.x < to.x ? 1 : -1;
+    int stepY = from.y < to.y ? 1 : -1;
+    int error = dx + dy;
+    int x = from.x;
+    int y = from.y;
+
+    while (x != to.x || y != to.y) {
+        int doubledError = 2 * error;
+        if (doubledError >= dy) {
+            error += dy;
+            x += stepX;
+        }
+        if (doubledError <= dx) {
+            error += dx;
+            y += stepY;
+        }
+
+        if (x >= 0 && y >= 0 && x < static_cast<int>(layout.columns) && y < static_cast<int>(layout.rows)) {
+            pendingPaint.emplace_back(x, y);
+        }
+    }
+}
+
+void InputHandler::flushPaint() {
+    if (pendingPaint.empty()) {
+        return;
+    }
+
+    if (onCellsPaint) {
+        onCellsPaint(pendingPaint, paintValue);
+    }
+    pendingPaint.clear();
 }
 
 void InputHandler::handleKeyPress(sf::Keyboard::Key key) {
@@ -169,6 +231,30 @@ void InputHandler::handleKeyPress(sf::Keyboard::Key key) {
             }
             break;
             
+        case sf::Keyboard::Key::S:
+            if (onSnapshotSave) {
+                onSnapshotSave();
+            }
+            break;
+            
+        case sf::Keyboard::Key::L:
+            if (onSnapshotLoad) {
+                onSnapshotLoad();
+            }
+            break;
+            
+        case sf::Keyboard::Key::O:
+            if (onCensus) {
+                onCensus();
+            }
+            break;
+            
+        case sf::Keyboard::Key::Left:
+            if (onStepBackward) {
+                onStepBackward(); // Key repeat scrubs further back
+            }
+            break;
+            
         case sf::Keyboard::Key::Equal:
         case sf::Keyboard::Key::Add:
             if (onSpeedChange) {
@@ -188,10 +274,34 @@ void InputHandler::handleKeyPress(sf::Keyboard::Key key) {
     }
 }
 
+bool InputHandler::handleControlShortcut(sf::Keyboard::Key key, bool shift) {
+    switch (key) {
+        case sf::Keyboard::Key::Z:
+            if (shift && onRedo) {
+                onRedo();
+            } else if (!shift && onUndo) {
+                onUndo();
+            }
+            return true;
+
+        case sf::Keyboard::Key::Y:
+            if (onRedo) {
+                onRedo();
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 void InputHandler::handleWindowResize(const sf::Vector2u& newSize) {
     sf::RenderWindow& window = gameEngine.getWindow();
     sf::View newView(sf::FloatRect({0.f, 0.f}, {static_cast<float>(newSize.x), static_cast<float>(newSize.y)}));
     window.setView(newView);
+
+    // Recompute the cached grid layout once for the new size
+    gameEngine.getRenderer().updateLayout(gameEngine.getGrid());
     
     // Notify UI manager to reinitialize buttons
     UIManager& uiManager = gameEngine.getUIManager();
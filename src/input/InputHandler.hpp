@@ -2,7 +2,10 @@
 #define INPUTHANDLER_HPP
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <functional>
+#include <utility>
+#include <vector>
 
 // Forward declarations
 class GameEngine;
@@ -18,21 +21,36 @@ public:
     void processEvents();
     
     // Event handler registration
-    void setOnCellToggle(std::function<void(int, int)> callback);
+    void setOnCellsPaint(std::function<void(const std::vector<std::pair<unsigned int, unsigned int>>&, bool)> callback);
     void setOnPauseToggle(std::function<void()> callback);
     void setOnSpeedChange(std::function<void(bool)> callback);
     void setOnPatternSeed(std::function<void(const std::string&)> callback);
     void setOnGridClear(std::function<void()> callback);
+    void setOnSnapshotSave(std::function<void()> callback);
+    void setOnSnapshotLoad(std::function<void()> callback);
+    void setOnUndo(std::function<void()> callback);
+    void setOnRedo(std::function<void()> callback);
+    void setOnStepBackward(std::function<void()> callback);
+    void setOnCensus(std::function<void()> callback);
+
+    // Identifies the current drag stroke, so its per-frame paints can be grouped
+    uint64_t getPaintStroke() const { return paintStroke; }
 
 private:
     GameEngine& gameEngine;
     
     // Event callbacks
-    std::function<void(int, int)> onCellToggle;
+    std::function<void(const std::vector<std::pair<unsigned int, unsigned int>>&, bool)> onCellsPaint;
     std::function<void()> onPauseToggle;
     std::function<void(bool)> onSpeedChange; // true = increase, false = decrease
     std::function<void(const std::string&)> onPatternSeed;
     std::function<void()> onGridClear;
+    std::function<void()> onSnapshotSave;
+    std::function<void()> onSnapshotLoad;
+    std::function<void()> onUndo;
+    std::function<void()> onRedo;
+    std::function<void()> onStepBackward;
+    std::function<void()> onCensus;
     
     // Event processing methods
     void handleWindowEvents(const sf::Event& event);
@@ -42,13 +60,27 @@ private:
     // Helper methods
     void handleMouseClick(const sf::Vector2i& mousePos);
     void handleMouseMove(const sf::Vector2i& mousePos);
+    void beginPaintStroke(const sf::Vector2i& mousePos);
+    void continuePaintStroke(const sf::Vector2i& mousePos);
+    void endPaintStroke();
+    void rasterizeSegment(sf::Vector2i from, sf::Vector2i to);
+    void flushPaint();
     void handleKeyPress(sf::Keyboard::Key key);
+    bool handleControlShortcut(sf::Keyboard::Key key, bool shift);
     void handleWindowResize(const sf::Vector2u& newSize);
     void handleWindowClose();
     
     // Input state
     sf::Vector2i lastMousePos;
     bool isMousePressed;
+
+    // Drag painting: cells a stroke gathers during a frame are applied in one
+    // bulk call, flushed early when the stroke ends
+    bool isPainting;
+    bool paintValue;
+    uint64_t paintStroke;
+    sf::Vector2i lastPaintCell;
+    std::vector<std::pair<unsigned int, unsigned int>> pendingPaint;
 };
 
 #endif // INPUTHANDLER_HPP
\ No newline at end of file
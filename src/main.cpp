@@ -30,10 +30,200 @@
  */
 
 #include "core/GameEngine.hpp"
+#include "core/Grid.hpp"
+#include "core/DeltaLog.hpp"
+#include "analysis/BoardBenchmark.hpp"
+#include "analysis/Lifespan.hpp"
+#include "analysis/RuleSweep.hpp"
+#include "analysis/SoupSearch.hpp"
 #include "patterns/PatternManager.hpp"
 #include <SFML/Graphics.hpp>
 #include <SFML/System/Angle.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
+
+/**
+ * Headless soup search: gol --soup-search <count> [--threads N] [--seed S]
+ * [--max-generations N]. Runs without opening a window and prints a census
+ * of the objects the soups settled into.
+ */
+static int runSoupSearch(int argc, char* argv[]) {
+  SoupSearchConfig config;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--soup-search" && i + 1 < argc) {
+      config.soupCount = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      config.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--seed" && i + 1 < argc) {
+      config.seed = std::strtoull(argv[++i], nullptr, 0);
+    } else if (arg == "--max-generations" && i + 1 < argc) {
+      config.maxGenerations = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    }
+  }
+
+  std::cout << "Searching " << config.soupCount << " " << config.soupSize << "x" << config.soupSize
+            << " soups with seed " << config.seed << std::endl;
+  SoupSearch search(config);
+  SoupSearchResult result = search.run([](uint64_t soupsDone, double seconds) {
+    std::cout << "  " << soupsDone << " soups (" << static_cast<uint64_t>(soupsDone / seconds)
+              << " soups/s)" << std::endl;
+  });
+
+  std::cout << result.soups << " soups in " << result.seconds << " s ("
+            << result.soupsPerSecond << " soups/s), " << result.unsettled << " unsettled" << std::endl;
+  std::cout << "Still lifes: " << result.stillLifes << ", oscillators: " << result.oscillators
+            << ", spaceships: " << result.spaceships << ", unclassified: " << result.unclassified << std::endl;
+
+  // Most common objects first
+  std::vector<std::pair<std::string, uint64_t>> objects(result.objectCounts.begin(), result.objectCounts.end());
+  std::stable_sort(objects.begin(), objects.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+  for (const auto& object : objects) {
+    std::cout << "  " << object.first << "\t" << object.second << std::endl;
+  }
+  return 0;
+}
+
+/**
+ * Headless lifespan measurement: gol --lifespan <pattern|file.rle>
+ * [--max-generations N] [--library dir]. Runs a built-in or loaded pattern in a growing
+ * universe until it stabilizes and reports when, with what population and
+ * how many gliders escaped.
+ */
+static int runLifespan(int argc, char* argv[]) {
+  LifespanConfig config;
+  std::string patternName;
+  std::string libraryDirectory;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--lifespan" && i + 1 < argc) {
+      patternName = argv[++i];
+    } else if (arg == "--max-generations" && i + 1 < argc) {
+      config.maxGenerations = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--library" && i + 1 < argc) {
+      libraryDirectory = argv[++i];
+    }
+  }
+
+  PatternManager patternManager;
+  if (!libraryDirectory.empty() && !patternManager.openLibrary(libraryDirectory)) {
+    std::cerr << "Could not open library: " << patternManager.getLastLoadStats().error << std::endl;
+    return 1;
+  }
+  if (!patternManager.hasPattern(patternName)) {
+    if (!patternManager.loadPatternFromFile(patternName)) {
+      std::cerr << "No pattern named '" << patternName << "': "
+                << patternManager.getLastLoadStats().error << std::endl;
+      return 1;
+    }
+    patternName = patternManager.getLastLoadStats().patternName;
+  }
+
+  std::cout << "Running '" << patternName << "' until it stabilizes" << std::endl;
+  Lifespan lifespan(config);
+  LifespanResult result = lifespan.run(patternManager.getPattern(patternName));
+
+  switch (result.outcome) {
+    case LifespanOutcome::Stabilized:
+      std::cout << "Stabilized at generation " << result.stabilizationGeneration << " with period "
+                << result.period << std::endl;
+      break;
+    case LifespanOutcome::UnboundedGrowth:
+      std::cout << "Unbounded growth detected by generation " << result.generations << ": "
+                << result.diagnosis << std::endl;
+      break;
+    case LifespanOutcome::GenerationLimit:
+      std::cout << "No result: " << result.diagnosis << std::endl;
+      break;
+  }
+  std::cout << "Final population " << result.finalPopulation << " plus " << result.escapedCells
+            << " cells in " << result.spaceships << " escaped spaceships (" << result.gliders
+            << " gliders)" << std::endl;
+  std::cout << result.generations << " generations in " << result.seconds << " s, universe "
+            << result.arenaSize << "x" << result.arenaSize << std::endl;
+  return result.outcome == LifespanOutcome::Stabilized ? 0 : 2;
+}
+
+/**
+ * Headless rule-space sweep: gol --rule-sweep <out.csv> [--seed S]
+ * [--threads N] [--max-generations N] [--rules first:count]. Runs one soup
+ * under every Life-like rule (or a range of rule indices) and writes each
+ * rule's final density, period and growth class to a CSV file.
+ */
+static int runRuleSweep(int argc, char* argv[]) {
+  RuleSweepConfig config;
+  std::string outputFile;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--rule-sweep" && i + 1 < argc) {
+      outputFile = argv[++i];
+    } else if (arg == "--threads" && i + 1 < argc) {
+      config.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--seed" && i + 1 < argc) {
+      config.seed = std::strtoull(argv[++i], nullptr, 0);
+    } else if (arg == "--max-generations" && i + 1 < argc) {
+      config.maxGenerations = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--rules" && i + 1 < argc) {
+      char* end = nullptr;
+      config.firstRule = static_cast<uint32_t>(std::strtoul(argv[++i], &end, 10));
+      if (*end == ':') {
+        config.ruleCount = static_cast<uint32_t>(std::strtoul(end + 1, nullptr, 10));
+      }
+    }
+  }
+  if (outputFile.empty()) {
+    std::cerr << "--rule-sweep needs an output file" << std::endl;
+    return 1;
+  }
+
+  RuleSweep sweep(config);
+  std::cout << "Sweeping rules with seed " << config.seed << std::endl;
+  RuleSweepResult result = sweep.run([](uint64_t rulesDone, double seconds) {
+    std::cout << "  " << rulesDone << " rules (" << static_cast<uint64_t>(rulesDone / seconds)
+              << " rules/s)" << std::endl;
+  });
+  std::cout << result.rules.size() << " rules in " << result.seconds << " s ("
+            << result.rulesPerSecond << " rules/s)" << std::endl;
+
+  if (!sweep.writeCsv(result, outputFile)) {
+    std::cerr << sweep.getError() << std::endl;
+    return 1;
+  }
+  std::cout << "Wrote " << outputFile << std::endl;
+  return 0;
+}
+
+/**
+ * Headless benchmark of the 60x40 board: gol --benchmark <generations> [--seed S].
+ * Steps one seeded soup as a Grid and as a FixedGrid and prints both speeds.
+ */
+static int runBenchmark(int argc, char* argv[]) {
+  BoardBenchmarkConfig config;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--benchmark" && i + 1 < argc) {
+      config.generations = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      config.seed = std::strtoull(argv[++i], nullptr, 0);
+    }
+  }
+
+  std::cout << "Stepping a " << BoardBenchmark::WIDTH << "x" << BoardBenchmark::HEIGHT << " soup with seed "
+            << config.seed << " for " << config.generations << " generations" << std::endl;
+  BoardBenchmark benchmark(config);
+  BoardBenchmarkResult result = benchmark.run();
+  std::cout << "Grid:      " << result.grid.seconds << " s (" << result.grid.generationsPerSecond
+            << " generations/s)" << std::endl;
+  std::cout << "FixedGrid: " << result.fixed.seconds << " s (" << result.fixed.generationsPerSecond
+            << " generations/s)" << std::endl;
+  if (!result.matched) {
+    std::cerr << "Grid and FixedGrid disagree on the final generation" << std::endl;
+    return 1;
+  }
+  return 0;
+}
 
 /**
  * Main function - Entry point for the Game of Life simulation
@@ -41,9 +231,30 @@
  * Initializes the game, displays control instructions to the user,
  * sets up an initial pattern, and starts the main game loop.
  *
+ * @param argc Argument count
+ * @param argv Optional path to an .rle/.mc pattern or .golsnap snapshot to load at startup,
+ *             or the name of a built-in or library pattern, plus --checkpoint-interval,
+ *             --checkpoint-file, --resume, --seed and --library options,
+ *             or --soup-search / --lifespan / --rule-sweep / --benchmark for a headless run
  * @return 0 on successful program completion
  */
-int main() {
+int main(int argc, char* argv[]) {
+  // Headless modes run before any window is created
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--soup-search") {
+      return runSoupSearch(argc, argv);
+    }
+    if (std::string(argv[i]) == "--lifespan") {
+      return runLifespan(argc, argv);
+    }
+    if (std::string(argv[i]) == "--rule-sweep") {
+      return runRuleSweep(argc, argv);
+    }
+    if (std::string(argv[i]) == "--benchmark") {
+      return runBenchmark(argc, argv);
+    }
+  }
+
   // Display comprehensive control instructions to help new users
   std::cout << "=====================================================" << std::endl;
   std::cout << "           Conway's Game of Life Simulator          " << std::endl;
@@ -58,6 +269,7 @@ int main() {
   std::cout << "─────────────────────────────────────────────────────" << std::endl;
   std::cout << "  Mouse Interaction:" << std::endl;
   std::cout << "    • Left Click Cell    - Toggle alive/dead state" << std::endl;
+  std::cout << "    • Click and Drag     - Paint cells along the stroke" << std::endl;
   std::cout << "    • Click UI Buttons   - Use control bar at top" << std::endl;
   std::cout << std::endl;
   std::cout << "  Keyboard Shortcuts:" << std::endl;
@@ -66,6 +278,12 @@ int main() {
   std::cout << "    • G                 - Create glider pattern" << std::endl;
   std::cout << "    • C                 - Clear entire grid" << std::endl;
   std::cout << "    • T                 - Test pattern (for debugging)" << std::endl;
+  std::cout << "    • O                 - Print a census of objects on the board" << std::endl;
+  std::cout << "    • Left Arrow        - Rewind one generation (hold to scrub)" << std::endl;
+  std::cout << "    • Ctrl+Z            - Undo last edit or generation" << std::endl;
+  std::cout << "    • Ctrl+Y / Ctrl+Shift+Z - Redo" << std::endl;
+  std::cout << "    • S                 - Save snapshot (universe.golsnap)" << std::endl;
+  std::cout << "    • L                 - Load snapshot (universe.golsnap)" << std::endl;
   std::cout << "    • + or =            - Increase simulation speed" << std::endl;
   std::cout << "    • -                 - Decrease simulation speed" << std::endl;
   std::cout << std::endl;
@@ -74,6 +292,32 @@ int main() {
   std::cout << "    • ▲                 - Speed up simulation" << std::endl;
   std::cout << "    • ▼                 - Speed down simulation" << std::endl;
   std::cout << "    • ●●●               - Generate random pattern" << std::endl;
+  std::cout << "    • Rewind            - Step back one generation" << std::endl;
+  std::cout << std::endl;
+  std::cout << "  Command Line:" << std::endl;
+  std::cout << "    • gol <file.rle|.mc>  - Start from a pattern file" << std::endl;
+  std::cout << "    • gol <file.golsnap>  - Resume a saved snapshot" << std::endl;
+  std::cout << "    • gol <pattern>       - Start from a built-in or library pattern" << std::endl;
+  std::cout << "    • --library <dir>     - Index a directory of .rle files by name" << std::endl;
+  std::cout << "    • --checkpoint-interval <seconds>" << std::endl;
+  std::cout << "                          - Checkpoint periodically in the background" << std::endl;
+  std::cout << "    • --checkpoint-file <file.golsnap>" << std::endl;
+  std::cout << "                          - Checkpoint path (default checkpoint.golsnap)" << std::endl;
+  std::cout << "    • --resume [file.golsnap]" << std::endl;
+  std::cout << "                          - Continue from the latest checkpoint" << std::endl;
+  std::cout << "    • --record <file.gollog> [--keyframe-interval N]" << std::endl;
+  std::cout << "                          - Log every generation as XOR deltas" << std::endl;
+  std::cout << "    • --replay <file.gollog> <generation>" << std::endl;
+  std::cout << "                          - Start from a recorded generation" << std::endl;
+  std::cout << "    • --seed <n>          - Start from a reproducible random soup" << std::endl;
+  std::cout << "    • --soup-search <count> [--threads N] [--seed S]" << std::endl;
+  std::cout << "                          - Headless census of random 16x16 soups" << std::endl;
+  std::cout << "    • --lifespan <pattern|file.rle> [--max-generations N] [--library dir]" << std::endl;
+  std::cout << "                          - Headless run until the pattern stabilizes" << std::endl;
+  std::cout << "    • --rule-sweep <out.csv> [--seed S] [--rules first:count]" << std::endl;
+  std::cout << "                          - Headless run of one soup under every B/S rule" << std::endl;
+  std::cout << "    • --benchmark <generations> [--seed S]" << std::endl;
+  std::cout << "                          - Headless speed test of the 60x40 board" << std::endl;
   std::cout << std::endl;
   std::cout << "TIP: Try the glider pattern (G) to see a pattern that" << std::endl;
   std::cout << "     moves across the grid, or random (R) for chaos!" << std::endl;
@@ -86,7 +330,117 @@ int main() {
   // Initialize with a classic glider pattern to demonstrate the Game of Life
   // The glider is a 5-cell pattern that travels diagonally across the grid,
   // moving one cell every 4 generations - a perfect introduction to the game
-  engine.getPatternManager().applyPattern(engine.getGrid(), "glider");
+  // A pattern file given on the command line takes its place
+  PatternManager& patternManager = engine.getPatternManager();
+  std::string initialPattern = "glider";
+
+  // Command-line options; any other argument names the startup file
+  std::string startupFile;
+  std::string checkpointFile = GameEngine::DEFAULT_CHECKPOINT_FILE;
+  float checkpointInterval = 0.0f;
+  bool resume = false;
+  std::string recordFile;
+  uint32_t keyframeInterval = DeltaLogFormat::DEFAULT_KEYFRAME_INTERVAL;
+  std::string replayFile;
+  uint64_t replayGeneration = 0;
+  bool seeded = false;
+  std::string libraryDirectory;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--checkpoint-interval" && i + 1 < argc) {
+      checkpointInterval = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--checkpoint-file" && i + 1 < argc) {
+      checkpointFile = argv[++i];
+    } else if (arg == "--record" && i + 1 < argc) {
+      recordFile = argv[++i];
+    } else if (arg == "--keyframe-interval" && i + 1 < argc) {
+      keyframeInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--replay" && i + 2 < argc) {
+      replayFile = argv[++i];
+      replayGeneration = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      patternManager.setRandomSeed(std::strtoull(argv[++i], nullptr, 0));
+      seeded = true;
+    } else if (arg == "--library" && i + 1 < argc) {
+      libraryDirectory = argv[++i];
+    } else if (arg == "--resume") {
+      resume = true;
+      if (i + 1 < argc && argv[i + 1][0] != '-') {
+        checkpointFile = argv[++i];
+      }
+    } else {
+      startupFile = arg;
+    }
+  }
+  if (resume) {
+    startupFile = checkpointFile;
+  }
+
+  if (!libraryDirectory.empty()) {
+    if (patternManager.openLibrary(libraryDirectory)) {
+      const PatternLibrary& library = patternManager.getLibrary();
+      std::cout << "Library " << libraryDirectory << ": " << library.getEntries().size() << " patterns, "
+                << library.getFilesScanned() << " files scanned in "
+                << patternManager.getLastLoadStats().seconds << " s" << std::endl;
+    } else {
+      std::cerr << "Could not open library: " << patternManager.getLastLoadStats().error << std::endl;
+    }
+  }
+
+  const std::string snapshotExtension = ".golsnap";
+  bool isSnapshot = startupFile.size() > snapshotExtension.size() &&
+                    startupFile.compare(startupFile.size() - snapshotExtension.size(),
+                                        snapshotExtension.size(), snapshotExtension) == 0;
+
+  if (!replayFile.empty()) {
+    if (engine.loadLogGeneration(replayFile, replayGeneration)) {
+      std::cout << "Replaying " << replayFile << " from generation "
+                << engine.getGrid().getGeneration() << std::endl;
+      initialPattern.clear();
+    }
+  } else if (isSnapshot) {
+    if (engine.loadSnapshot(startupFile)) {
+      std::cout << "Restored snapshot " << startupFile << " at generation "
+                << engine.getGrid().getGeneration() << std::endl;
+      initialPattern.clear();
+    }
+  } else if (!startupFile.empty() && patternManager.hasPattern(startupFile)) {
+    initialPattern = startupFile;
+  } else if (!startupFile.empty()) {
+    if (patternManager.loadPatternFromFile(startupFile, &engine.getGrid())) {
+      const PatternLoadStats& stats = patternManager.getLastLoadStats();
+      std::cout << "Loaded '" << stats.patternName << "' from " << startupFile << ": "
+                << stats.bytesRead << " bytes in " << stats.seconds << " s ("
+                << stats.megabytesPerSecond << " MB/s)" << std::endl;
+      initialPattern = stats.patternName;
+    } else {
+      std::cerr << "Could not load " << startupFile << ": "
+                << patternManager.getLastLoadStats().error << std::endl;
+    }
+  }
+
+  if (seeded && startupFile.empty() && replayFile.empty()) {
+    initialPattern = "random";
+  }
+
+  if (!initialPattern.empty()) {
+    engine.seedPattern(initialPattern);
+    if (initialPattern == "random") {
+      std::cout << "Random soup seed: " << patternManager.getLastRandomSeed() << std::endl;
+    }
+  }
+
+  if (!recordFile.empty() && engine.startRecording(recordFile, keyframeInterval)) {
+    std::cout << "Recording history to " << recordFile << " (keyframe every "
+              << keyframeInterval << " generations)" << std::endl;
+  }
+
+  if (checkpointInterval > 0.0f) {
+    engine.enableCheckpoints(checkpointFile, checkpointInterval);
+    std::cout << "Checkpointing to " << checkpointFile << " every "
+              << checkpointInterval << " s" << std::endl;
+  }
 
   // Start the main game loop - this will run until the user closes the window
   // The loop handles events, updates the simulation state, and renders graphics
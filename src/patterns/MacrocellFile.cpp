@@ -0,0 +1,166 @@
+#include "MacrocellFile.hpp"
+#include "../core/QuadTree.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+MacrocellFile::MacrocellFile() : rule("B3/S23"), generation(0), bytesRead(0) {
+}
+
+bool MacrocellFile::read(const std::string& filename, QuadTree& tree) {
+    error.clear();
+    bytesRead = 0;
+    tree.clear();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, 4, "[M2]") != 0) {
+        error = "Missing [M2] header in " + filename;
+        return false;
+    }
+    bytesRead += line.size() + 1;
+
+    // Node ids by line number; line 0 stands for the empty node
+    std::vector<uint32_t> ids(1, QuadTree::EMPTY);
+    std::vector<unsigned int> levels(1, QuadTree::LEAF_LEVEL);
+
+    while (std::getline(file, line)) {
+        bytesRead += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        if (line[0] == '#') {
+            if (line.compare(0, 2, "#R") == 0) {
+                std::istringstream(line.substr(2)) >> rule;
+            } else if (line.compare(0, 2, "#G") == 0) {
+                generation = std::strtoull(line.c_str() + 2, nullptr, 10);
+            }
+            continue;
+        }
+
+        if (line[0] >= '0' && line[0] <= '9') {
+            std::istringstream fields(line);
+            unsigned int level = 0;
+            uint64_t children[4] = {0, 0, 0, 0};
+            fields >> level >> children[0] >> children[1] >> children[2] >> children[3];
+            if (!fields || level <= QuadTree::LEAF_LEVEL || level > 62) {
+                error = "Malformed node line: " + line;
+                return false;
+            }
+
+            uint32_t childIds[4];
+            for (int i = 0; i < 4; ++i) {
+                if (children[i] >= ids.size() || (children[i] != 0 && levels[children[i]] != level - 1)) {
+                    error = "Bad child reference in node line: " + line;
+                    return false;
+                }
+                childIds[i] = ids[children[i]];
+            }
+
+            ids.push_back(tree.node(level, childIds[0], childIds[1], childIds[2], childIds[3]));
+            levels.push_back(level);
+            continue;
+        }
+
+        // Leaf: rows of '.' and '*' terminated by '$'
+        uint64_t bits = 0;
+        unsigned int x = 0;
+        unsigned int y = 0;
+        for (char c : line) {
+            if (c == '$') {
+                ++y;
+                x = 0;
+            } else if (c == '*' || c == '.') {
+                if (x >= QuadTree::LEAF_SIZE || y >= QuadTree::LEAF_SIZE) {
+                    error = "Leaf exceeds 8x8: " + line;
+                    return false;
+                }
+                if (c == '*') {
+                    bits |= 1ULL << (y * QuadTree::LEAF_SIZE + x);
+                }
+                ++x;
+            } else {
+                error = "Unexpected character in leaf: " + line;
+                return false;
+            }
+        }
+        ids.push_back(tree.leaf(bits));
+        levels.push_back(QuadTree::LEAF_LEVEL);
+    }
+
+    // The last line describes the root
+    tree.setRoot(ids.back(), levels.back());
+    return true;
+}
+
+bool MacrocellFile::write(const QuadTree& tree, const std::string& filename) {
+    error.clear();
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    file << "[M2] (gol)\n";
+    file << "#R " << rule << "\n";
+    if (generation > 0) {
+        file << "#G " << generation << "\n";
+    }
+
+    // Post-order walk; each distinct node is written once and numbered by its line
+    std::unordered_map<uint32_t, uint64_t> lineNumbers;
+    uint64_t nextLine = 1;
+
+    std::function<uint64_t(uint32_t)> emit = [&](uint32_t id) -> uint64_t {
+        if (id == QuadTree::EMPTY) return 0;
+
+        auto it = lineNumbers.find(id);
+        if (it != lineNumbers.end()) return it->second;
+
+        const QuadTree::Node& current = tree.getNode(id);
+        if (current.level == QuadTree::LEAF_LEVEL) {
+            std::string text;
+            for (unsigned int y = 0; y < QuadTree::LEAF_SIZE; ++y) {
+                uint64_t rowBits = (current.leafBits >> (y * QuadTree::LEAF_SIZE)) & 0xFFULL;
+                while (rowBits) {
+                    text.push_back((rowBits & 1ULL) ? '*' : '.');
+                    rowBits >>= 1;
+                }
+                text.push_back('$');
+            }
+            // Trailing empty rows are implied
+            while (text.size() > 1 && text[text.size() - 2] == '$') {
+                text.pop_back();
+            }
+            file << text << "\n";
+        } else {
+            uint64_t children[4];
+            for (int i = 0; i < 4; ++i) {
+                children[i] = emit(current.children[i]);
+            }
+            file << current.level << ' ' << children[0] << ' ' << children[1] << ' '
+                 << children[2] << ' ' << children[3] << "\n";
+        }
+
+        lineNumbers.emplace(id, nextLine);
+        return nextLine++;
+    };
+
+    emit(tree.getRoot());
+    file.close();
+
+    if (!file) {
+        error = "Failed writing " + filename;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef MACROCELLFILE_HPP
+#define MACROCELLFILE_HPP
+
+#include <cstdint>
+#include <string>
+
+class QuadTree;
+
+// Reader and writer for Golly's macrocell (.mc) format, which serializes the
+// canonical quadtree directly: one line per distinct node, children referenced
+// by line number. Both directions cost O(distinct nodes), not O(area).
+class MacrocellFile {
+public:
+    MacrocellFile();
+
+    bool read(const std::string& filename, QuadTree& tree);
+    bool write(const QuadTree& tree, const std::string& filename);
+
+    // Header fields of the last file read (written back by write())
+    const std::string& getRule() const { return rule; }
+    void setRule(const std::string& newRule) { rule = newRule; }
+    uint64_t getGeneration() const { return generation; }
+    void setGeneration(uint64_t newGeneration) { generation = newGeneration; }
+
+    const std::string& getError() const { return error; }
+    uint64_t getBytesRead() const { return bytesRead; }
+
+private:
+    std::string rule;
+    uint64_t generation;
+    std::string error;
+    uint64_t bytesRead;
+};
+
+#endif // MACROCELLFILE_HPP
@@ -0,0 +1,272 @@
+#include "PatternLibrary.hpp"
+#include "PatternManager.hpp"
+#include "RleReader.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Rough heap footprint of a decoded pattern, for the cache bound
+size_t patternBytes(const Pattern& pattern) {
+    return sizeof(Pattern) + pattern.rows.size() * sizeof(uint64_t) + pattern.name.size() +
+           pattern.description.size() + pattern.rule.size();
+}
+
+bool isRleFile(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".rle";
+}
+
+} // namespace
+
+PatternLibrary::PatternLibrary(size_t cacheLimit)
+    : cacheLimit(cacheLimit),
+      cacheBytes(0),
+      cacheHits(0),
+      cacheMisses(0),
+      filesScanned(0) {
+}
+
+bool PatternLibrary::open(const std::string& path) {
+    error.clear();
+    std::error_code status;
+    if (!fs::is_directory(path, status)) {
+        error = path + " is not a directory";
+        return false;
+    }
+
+    // Reuse whatever a previous open indexed; a missing or unreadable index
+    // just means every file is scanned
+    const std::string indexFile = (fs::path(path) / INDEX_FILENAME).string();
+    std::vector<PatternIndexEntry> saved;
+    readIndex(indexFile, saved);
+    std::map<std::string, const PatternIndexEntry*> savedByFile;
+    for (const PatternIndexEntry& entry : saved) {
+        savedByFile[entry.file] = &entry;
+    }
+
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(path, status), end; !status && it != end; it.increment(status)) {
+        if (it->is_regular_file(status) && isRleFile(it->path())) {
+            files.push_back(it->path());
+        }
+    }
+    if (status) {
+        error = "Cannot list " + path + ": " + status.message();
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<PatternIndexEntry> indexed;
+    bool changed = false;
+    filesScanned = 0;
+    RleReader reader;
+    for (const fs::path& file : files) {
+        PatternIndexEntry entry;
+        entry.file = file.lexically_relative(path).generic_string();
+        entry.fileSize = fs::file_size(file, status);
+        entry.modified = static_cast<int64_t>(fs::last_write_time(file, status).time_since_epoch().count());
+        if (status) continue;
+
+        auto known = savedByFile.find(entry.file);
+        if (known != savedByFile.end() && known->second->fileSize == entry.fileSize &&
+            known->second->modified == entry.modified) {
+            indexed.push_back(*known->second);
+            continue;
+        }
+
+        // New or changed: parse the header and count cells, nothing is decoded.
+        // Unreadable files stay in the index without a name, so they are not
+        // rescanned until they change.
+        changed = true;
+        ++filesScanned;
+        RleInfo info;
+        const size_t maxLength = std::numeric_limits<uint16_t>::max();
+        if (!reader.scan(file.string(), info) || entry.file.size() > maxLength ||
+            info.name.size() > maxLength || info.rule.size() > maxLength) {
+            indexed.push_back(entry);
+            continue;
+        }
+        entry.name = info.name;
+        entry.rule = info.rule;
+        entry.description = info.description.substr(0, maxLength);
+        entry.width = info.width;
+        entry.height = info.height;
+        entry.population = info.population;
+        entry.bodyOffset = info.bodyOffset;
+        indexed.push_back(entry);
+    }
+    changed = changed || indexed.size() != saved.size();
+
+    directory = path;
+    entries.clear();
+    byName.clear();
+    for (const PatternIndexEntry& entry : indexed) {
+        if (!entry.name.empty() && byName.emplace(entry.name, entries.size()).second) {
+            entries.push_back(entry);
+        }
+    }
+    recent.clear();
+    cache.clear();
+    cacheBytes = 0;
+
+    // A library on read-only storage still works, it just rescans next time;
+    // getError() says why the index was not saved
+    if (changed) {
+        writeIndex(indexFile, indexed);
+    }
+    return true;
+}
+
+const PatternIndexEntry* PatternLibrary::find(const std::string& name) const {
+    auto it = byName.find(name);
+    return it == byName.end() ? nullptr : &entries[it->second];
+}
+
+std::shared_ptr<const Pattern> PatternLibrary::load(const std::string& name) {
+    auto cached = cache.find(name);
+    if (cached != cache.end()) {
+        ++cacheHits;
+        recent.splice(recent.begin(), recent, cached->second.position);
+        return cached->second.pattern;
+    }
+
+    const PatternIndexEntry* entry = find(name);
+    if (!entry) {
+        error = "No pattern named '" + name + "' in " + directory;
+        return nullptr;
+    }
+
+    ++cacheMisses;
+    RleInfo info;
+    info.name = entry->name;
+    info.rule = entry->rule;
+    info.description = entry->description;
+    info.width = entry->width;
+    info.height = entry->height;
+    info.population = entry->population;
+    info.bodyOffset = entry->bodyOffset;
+
+    RleReader reader;
+    std::unique_ptr<Pattern> decoded = reader.read((fs::path(directory) / entry->file).string(), info);
+    if (!decoded) {
+        error = reader.getError();
+        return nullptr;
+    }
+
+    std::shared_ptr<const Pattern> pattern(std::move(decoded));
+    recent.push_front(name);
+    CacheEntry slot{pattern, patternBytes(*pattern), recent.begin()};
+    cacheBytes += slot.bytes;
+    cache.emplace(name, std::move(slot));
+    evict();
+    return pattern;
+}
+
+void PatternLibrary::evict() {
+    // The newest entry always stays, even if it alone exceeds the limit;
+    // evicted patterns live on while a caller still holds them
+    while (cacheBytes > cacheLimit && cache.size() > 1) {
+        auto victim = cache.find(recent.back());
+        cacheBytes -= victim->second.bytes;
+        cache.erase(victim);
+        recent.pop_back();
+    }
+}
+
+bool PatternLibrary::readIndex(const std::string& filename, std::vector<PatternIndexEntry>& loaded) const {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    IndexHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        return false;
+    }
+
+    std::vector<PatternIndexEntry> result;
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        IndexRecord record;
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) return false;
+
+        PatternIndexEntry entry;
+        entry.name.resize(record.nameLength);
+        entry.file.resize(record.fileLength);
+        entry.rule.resize(record.ruleLength);
+        entry.description.resize(record.descriptionLength);
+        if (!file.read(&entry.name[0], record.nameLength) || !file.read(&entry.file[0], record.fileLength) ||
+            !file.read(&entry.rule[0], record.ruleLength) ||
+            !file.read(&entry.description[0], record.descriptionLength)) {
+            return false;
+        }
+        entry.width = record.width;
+        entry.height = record.height;
+        entry.population = record.population;
+        entry.bodyOffset = record.bodyOffset;
+        entry.fileSize = record.fileSize;
+        entry.modified = record.modified;
+        result.push_back(std::move(entry));
+    }
+
+    loaded = std::move(result);
+    return true;
+}
+
+bool PatternLibrary::writeIndex(const std::string& filename, const std::vector<PatternIndexEntry>& indexed) {
+    // Written beside the final name and renamed, so readers never see half an index
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open " + tempFilename + " for writing";
+        return false;
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(indexed.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const PatternIndexEntry& entry : indexed) {
+        IndexRecord record{};
+        record.width = entry.width;
+        record.height = entry.height;
+        record.population = entry.population;
+        record.bodyOffset = entry.bodyOffset;
+        record.fileSize = entry.fileSize;
+        record.modified = entry.modified;
+        record.nameLength = static_cast<uint16_t>(entry.name.size());
+        record.fileLength = static_cast<uint16_t>(entry.file.size());
+        record.ruleLength = static_cast<uint16_t>(entry.rule.size());
+        record.descriptionLength = static_cast<uint16_t>(entry.description.size());
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+        file.write(entry.file.data(), static_cast<std::streamsize>(entry.file.size()));
+        file.write(entry.rule.data(), static_cast<std::streamsize>(entry.rule.size()));
+        file.write(entry.description.data(), static_cast<std::streamsize>(entry.description.size()));
+    }
+
+    file.close();
+    if (!file) {
+        error = "Failed writing " + tempFilename;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+        error = "Cannot replace " + filename;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
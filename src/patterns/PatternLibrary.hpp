@@ -0,0 +1,114 @@
+#ifndef PATTERNLIBRARY_HPP
+#define PATTERNLIBRARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Pattern;
+
+// One indexed pattern file
+struct PatternIndexEntry {
+    std::string name;           // #N name, or the file name without extension
+    std::string file;           // Path relative to the library directory
+    std::string rule;
+    std::string description;    // First #C comment
+    unsigned int width = 0;
+    unsigned int height = 0;
+    uint64_t population = 0;
+    uint64_t bodyOffset = 0;    // Where the RLE runs start, past the header
+    uint64_t fileSize = 0;      // Size and modification time when indexed,
+    int64_t modified = 0;       // to tell whether the entry is stale
+};
+
+// A directory of RLE files served on demand. open() builds a compact index
+// of every pattern (name, description, size, population and body offset) and saves it
+// next to the files, so later opens only rescan files that changed. A
+// pattern is decoded from its body offset the first time it is asked for
+// and kept in an LRU cache whose decoded size is bounded by cacheLimit.
+class PatternLibrary {
+public:
+    static constexpr const char* INDEX_FILENAME = "patterns.golidx";
+    static constexpr char MAGIC[8] = {'G', 'O', 'L', 'P', 'I', 'D', 'X', '\0'};
+    static constexpr uint32_t VERSION = 2;   // 2 added descriptions
+    static constexpr size_t DEFAULT_CACHE_LIMIT = 64 << 20;
+
+    explicit PatternLibrary(size_t cacheLimit = DEFAULT_CACHE_LIMIT);
+
+    // Indexes every .rle file under `directory`. Entries of a saved index are
+    // reused while the file's size and modification time match; the index
+    // is rewritten when anything was added, changed or removed. If two files
+    // share a name, the first in path order wins. Failing to save the index
+    // does not fail the open, but leaves the reason in getError().
+    bool open(const std::string& directory);
+    bool isOpen() const { return !directory.empty(); }
+
+    const PatternIndexEntry* find(const std::string& name) const;
+    const std::vector<PatternIndexEntry>& getEntries() const { return entries; }
+
+    // Decodes on first use; returns nullptr (see getError) if the pattern is
+    // unknown or its file can no longer be read
+    std::shared_ptr<const Pattern> load(const std::string& name);
+
+    // Cache and index statistics
+    size_t getCacheBytes() const { return cacheBytes; }
+    size_t getCacheLimit() const { return cacheLimit; }
+    size_t getCachedCount() const { return cache.size(); }
+    uint64_t getCacheHits() const { return cacheHits; }
+    uint64_t getCacheMisses() const { return cacheMisses; }
+    unsigned int getFilesScanned() const { return filesScanned; }
+
+    const std::string& getError() const { return error; }
+
+private:
+    struct IndexHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entryCount;
+    };
+
+    // Fixed part of an entry; name, file, rule and description follow it in that order
+    struct IndexRecord {
+        uint32_t width;
+        uint32_t height;
+        uint64_t population;
+        uint64_t bodyOffset;
+        uint64_t fileSize;
+        int64_t modified;
+        uint16_t nameLength;
+        uint16_t fileLength;
+        uint16_t ruleLength;
+        uint16_t descriptionLength;
+    };
+    static_assert(sizeof(IndexRecord) == 48, "Index records must stay 48 bytes");
+
+    struct CacheEntry {
+        std::shared_ptr<const Pattern> pattern;
+        size_t bytes;
+        std::list<std::string>::iterator position;
+    };
+
+    std::string directory;
+    std::vector<PatternIndexEntry> entries;
+    std::unordered_map<std::string, size_t> byName;
+
+    // Most recently used first
+    std::list<std::string> recent;
+    std::unordered_map<std::string, CacheEntry> cache;
+    size_t cacheLimit;
+    size_t cacheBytes;
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+    unsigned int filesScanned;
+    std::string error;
+
+    bool readIndex(const std::string& filename, std::vector<PatternIndexEntry>& loaded) const;
+    bool writeIndex(const std::string& filename, const std::vector<PatternIndexEntry>& indexed);
+    void evict();
+};
+
+#endif // PATTERNLIBRARY_HPP
@@ -1,17 +1,190 @@
 #include "PatternManager.hpp"
 #include "../core/Grid.hpp"
+#include "../core/BitOps.hpp"
+#include "../core/CounterRng.hpp"
+#include "RleReader.hpp"
+#include "RleWriter.hpp"
+#include "MacrocellFile.hpp"
+#include "StaticPattern.hpp"
+#include "../core/LifeRule.hpp"
+#include "../core/QuadTree.hpp"
+#include <chrono>
+#include <algorithm>
+#include <new>
 #include <random>
 #include <stdexcept>
 
+namespace {
+
+// Built-in patterns as RLE bodies, decoded into packed rows at compile time
+constexpr char GLIDER[] = "bo$2bo$3o!";
+constexpr char BEACON[] = "2o$2o$2b2o$2b2o!";
+constexpr char BLINKER[] = "3o!";
+constexpr char TOAD[] = "b3o$3o!";
+constexpr char BLOCK[] = "2o$2o!";
+constexpr char BEEHIVE[] = "b2o$o2bo$b2o!";
+constexpr char LOAF[] = "b2o$o2bo$bobo$2bo!";
+constexpr char BOAT[] = "2o$obo$bo!";
+constexpr char TUB[] = "bo$obo$bo!";
+// Corner, edge and centre markers for checking coordinates
+constexpr char TEST[] = "o4bo4bo4bo3bo5$o18bo3$10bo$10bo$o7b5o6bo$10bo$10bo3$o18bo4$o4bo4bo4bo3bo!";
+
+// Workloads: methuselahs that run for hundreds or thousands of generations,
+// and patterns that grow forever
+constexpr char GLIDER_GUN[] =
+    "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bobo$10bo5bo7bo$11bo3bo$12b2o!";
+constexpr char R_PENTOMINO[] = "b2o$2o$bo!";
+constexpr char ACORN[] = "bo$3bo$2o2b3o!";
+constexpr char DIEHARD[] = "6bo$2o$bo3b3o!";
+constexpr char B_HEPTOMINO[] = "ob2o$3o$bo!";
+constexpr char PI_HEPTOMINO[] = "3o$obo$obo!";
+constexpr char RABBITS[] = "o3b3o$3o2bo$bo!";
+// The six methuselahs above, repeated on a 4x4 lattice 12 cells apart
+constexpr char METHUSELAH_FIELD[] =
+    "b2o10bo16bo5bob2o$2o13bo8b2o10b3o$bo10b2o2b3o6bo3b3o5bo10$3o9bo3b3o6b2o10bo$obo9b3o2bo6b2o13bo$obo10bo11bo10b2o2b3o10$6bo5bob2o8b3o9bo3b3o$2o10b3o9bobo9b3o2bo$bo3b3o5bo10bobo10bo10$b2o10bo16bo5bob2o$2o13bo8b2o10b3o$bo10b2o2b3o6bo3b3o5bo!";
+// Smallest patterns known to grow forever: each becomes a switch engine
+// that lays a trail of blocks
+constexpr char SWITCH_ENGINE[] = "6bo$4bob2o$4bobo$4bo$2bo$obo!";
+constexpr char SWITCH_ENGINE_5X5[] = "3obo$o$3b2o$b2obo$obobo!";
+constexpr char INFINITE_GROWTH_LINE[] = "8ob5o3b3o6b7ob5o!";
+// Gosper's puffer train: two lightweight spaceships escort a spark that
+// burns at c/2, leaving smoke that settles into debris and gliders
+constexpr char PUFFER_TRAIN[] = "3bo$4bo$o3bo$b4o4$o$b2o$2bo$2bo$bo3$3bo$4bo$o3bo$b4o!";
+// Max, the smallest known spacefiller: its edges advance at c/2 on all four
+// sides and fill the plane behind them with a striped agar, so the
+// population grows quadratically
+constexpr char MAX[] =
+    "18bo$17b3o$12b3o4b2o$11bo2b3o2bob2o$10bo3bobo2bobo$10bo4bobobobob2o$12bo4bobo3b2o$4o5bobo4bo3bob3o$"
+    "o3b2obob3ob2o9b2o$o5b2o5bo$bo2b2obo2bo2bob2o$7bobobobobobo5b4o$bo2b2obo2bo2bo2b2obob2o3bo$"
+    "o5b2o3bobobo3b2o5bo$o3b2obob2o2bo2bo2bob2o2bo$4o5bobobobobobo$10b2obo2bo2bob2o2bo$13bo5b2o5bo$"
+    "b2o9b2ob3obob2o3bo$2b3obo3bo4bobo5b4o$2b2o3bobo4bo$2b2obobobobo4bo$5bobo2bobo3bo$4b2obo2b3o2bo$"
+    "6b2o4b3o$7b3o$8bo!";
+
+template <const char* RLE>
+constexpr auto BITMAP = staticpattern::decode<staticpattern::rleWidth(RLE), staticpattern::rleHeight(RLE)>(RLE);
+
+// Eight guns in a row; their glider streams run parallel without touching
+constexpr auto GUN_ARRAY = staticpattern::repeat<8, 48>(BITMAP<GLIDER_GUN>);
+
+struct BuiltInPattern {
+    const char* name;
+    const char* description;
+    LifeRule rule;
+    unsigned int width;
+    unsigned int height;
+    const uint64_t* rows;
+};
+
+template <unsigned int W, unsigned int H>
+constexpr BuiltInPattern builtIn(const char* name, const char* description,
+                                 const staticpattern::Bitmap<W, H>& bitmap) {
+    return {name, description, LifeRule::fromString("B3/S23"), W, H, bitmap.rows};
+}
+
+// Sorted by name
+constexpr BuiltInPattern BUILT_IN_PATTERNS[] = {
+    builtIn("acorn", "Methuselah that stabilizes after 5206 generations", BITMAP<ACORN>),
+    builtIn("b-heptomino", "Methuselah that stabilizes after 148 generations", BITMAP<B_HEPTOMINO>),
+    builtIn("beacon", "Oscillating beacon pattern with period 2", BITMAP<BEACON>),
+    builtIn("beehive", "Six-cell still life", BITMAP<BEEHIVE>),
+    builtIn("blinker", "Simple oscillating pattern with period 2", BITMAP<BLINKER>),
+    builtIn("block", "The most common still life", BITMAP<BLOCK>),
+    builtIn("boat", "Five-cell still life", BITMAP<BOAT>),
+    builtIn("diehard", "Seven cells that vanish after 130 generations", BITMAP<DIEHARD>),
+    builtIn("glider", "Classic glider pattern that moves diagonally", BITMAP<GLIDER>),
+    builtIn("glider_gun", "Gosper glider gun - creates a glider every 30 generations", BITMAP<GLIDER_GUN>),
+    builtIn("gun_array", "Eight Gosper guns side by side, for sustained linear growth", GUN_ARRAY),
+    builtIn("infinite_growth_line", "One cell high pattern that grows forever", BITMAP<INFINITE_GROWTH_LINE>),
+    builtIn("loaf", "Seven-cell still life", BITMAP<LOAF>),
+    builtIn("max", "Smallest known spacefiller - fills the plane at c/2, for quadratic growth", BITMAP<MAX>),
+    builtIn("methuselah_field", "Sixteen interacting methuselahs", BITMAP<METHUSELAH_FIELD>),
+    builtIn("pi-heptomino", "Methuselah that stabilizes after 173 generations", BITMAP<PI_HEPTOMINO>),
+    builtIn("puffer_train", "Gosper's puffer train - moves at c/2 leaving debris and gliders", BITMAP<PUFFER_TRAIN>),
+    builtIn("r-pentomino", "Methuselah that stabilizes after 1103 generations", BITMAP<R_PENTOMINO>),
+    builtIn("rabbits", "Methuselah that stabilizes after 17331 generations", BITMAP<RABBITS>),
+    builtIn("switch_engine", "Ten-cell pattern that grows forever", BITMAP<SWITCH_ENGINE>),
+    builtIn("switch_engine_5x5", "Smallest square pattern that grows forever", BITMAP<SWITCH_ENGINE_5X5>),
+    builtIn("test", "Test pattern for coordinate verification", BITMAP<TEST>),
+    builtIn("toad", "Oscillating toad pattern with period 2", BITMAP<TOAD>),
+    builtIn("tub", "Four-cell still life", BITMAP<TUB>),
+};
+
+const BuiltInPattern* findBuiltIn(const std::string& name) {
+    for (const BuiltInPattern& pattern : BUILT_IN_PATTERNS) {
+        if (name == pattern.name) {
+            return &pattern;
+        }
+    }
+    return nullptr;
+}
+
+// The grid only simulates B3/S23, so a pattern written for another rule
+// would silently evolve differently. No rule at all means Life.
+bool isSupportedRule(const std::string& rule) {
+    LifeRule parsed;
+    return rule.empty() || (LifeRule::parse(rule, parsed) && parsed == LifeRule());
+}
+
+std::string unsupportedRuleError(const std::string& name, const std::string& rule) {
+    return name + " uses rule " + rule + ", but only " + LifeRule().toString() + " is supported";
+}
+
+} // namespace
+
 Pattern::Pattern(const std::string& name, const std::string& desc,
                 const std::vector<std::vector<bool>>& pattern)
-    : name(name), description(desc), cells(pattern) {
-    height = cells.size();
-    width = height > 0 ? cells[0].size() : 0;
+    : Pattern(name, desc, pattern.empty() ? 0 : pattern[0].size(), pattern.size()) {
+    for (unsigned int y = 0; y < height; ++y) {
+        for (unsigned int x = 0; x < width && x < pattern[y].size(); ++x) {
+            if (pattern[y][x]) {
+                setCell(x, y, true);
+            }
+        }
+    }
+}
+
+Pattern::Pattern(const std::string& name, const std::string& desc,
+                 unsigned int width, unsigned int height)
+    : name(name), description(desc), rule("B3/S23"), width(width), height(height),
+      wordsPerRow((width + 63) / 64),
+      rows(static_cast<size_t>(wordsPerRow) * height, 0) {
+}
+
+Pattern::Pattern(const std::string& name, const std::string& desc,
+                 unsigned int width, unsigned int height, const uint64_t* rows)
+    : Pattern(name, desc, width, height) {
+    std::copy(rows, rows + this->rows.size(), this->rows.begin());
+}
+
+bool Pattern::getCell(unsigned int x, unsigned int y) const {
+    if (x >= width || y >= height) return false;
+    return (getRow(y)[x / 64] >> (x % 64)) & 1ULL;
+}
+
+void Pattern::setCell(unsigned int x, unsigned int y, bool alive) {
+    if (x >= width || y >= height) return;
+    uint64_t bit = 1ULL << (x % 64);
+    if (alive) {
+        getRow(y)[x / 64] |= bit;
+    } else {
+        getRow(y)[x / 64] &= ~bit;
+    }
+}
+
+void Pattern::setRun(unsigned int x, unsigned int y, unsigned int count) {
+    if (y >= height || x >= width) return;
+
+    unsigned int end = x + std::min(count, width - x);
+    uint64_t* row = getRow(y);
+    while (x < end) {
+        unsigned int bit = x % 64;
+        unsigned int span = std::min(64 - bit, end - x);
+        row[x / 64] |= bitops::lowMask(span) << bit;
+        x += span;
+    }
 }
 
 PatternManager::PatternManager() {
-    initializeBuiltInPatterns();
 }
 
 void PatternManager::applyPattern(Grid& grid, const std::string& patternName) {
@@ -29,41 +202,80 @@ void PatternManager::applyPattern(Grid& grid, const std::string& patternName) {
         throw std::invalid_argument("Pattern not found: " + patternName);
     }
 
-    clearGrid(grid);
-    applyPatternCentered(grid, patternName);
+    auto macrocell = macrocellPatterns.find(patternName);
+    if (macrocell != macrocellPatterns.end()) {
+        const MacrocellPattern& loaded = macrocell->second;
+        unsigned int left = loaded.width < grid.getWidth() ? (grid.getWidth() - loaded.width) / 2 : 0;
+        unsigned int top = loaded.height < grid.getHeight() ? (grid.getHeight() - loaded.height) / 2 : 0;
+        placeMacrocell(grid, patternName, loaded, left, top, true);
+        return;
+    }
+
+    const Pattern& pattern = getPattern(patternName);
+    auto centerPos = calculateCenterPosition(grid, pattern);
+    const unsigned int left = centerPos.first;
+    const unsigned int top = centerPos.second;
+
+    // The copy blit overwrites the pattern's rectangle, so old cells are only
+    // cleared in the live band around it and the edit stays O(pattern) on an
+    // empty or sparse grid
+    const unsigned int width = grid.getWidth();
+    for (unsigned int y = grid.getLiveTop(); y <= grid.getLiveBottom(); ++y) {
+        if (y < top || y - top >= pattern.height) {
+            grid.fillRect(0, y, width, 1, false);
+        } else {
+            grid.fillRect(0, y, left, 1, false);
+            grid.fillRect(left + pattern.width, y, width, 1, false);
+        }
+    }
+    grid.blit(pattern.rows.data(), pattern.wordsPerRow, pattern.width, pattern.height,
+              left, top, Grid::BlitMode::Copy);
 }
 
 void PatternManager::applyRandomPattern(Grid& grid, float density) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-
-    clearGrid(grid);
+    uint64_t seed = pendingRandomSeed;
+    if (!hasPendingRandomSeed) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    hasPendingRandomSeed = false;
+    applyRandomPattern(grid, density, seed);
+}
 
-    for (unsigned int y = 0; y < grid.getHeight(); ++y) {
-        for (unsigned int x = 0; x < grid.getWidth(); ++x) {
-            if (dis(gen) < density) {
-                grid.setCell(x, y, true);
-            }
+void PatternManager::applyRandomPattern(Grid& grid, float density, uint64_t seed, unsigned int threads) {
+    lastRandomSeed = seed;
+
+    // Each word's bits come from the counter-based generator keyed on its
+    // position, so rows can be filled in parallel with a fixed result
+    const uint32_t threshold = counterrng::densityThreshold(density);
+    const uint64_t wordsPerRow = grid.getWordsPerRow();
+    grid.generateRows([seed, threshold, wordsPerRow](unsigned int y, uint64_t* row) {
+        const uint64_t rowStart = y * wordsPerRow;
+        for (uint64_t i = 0; i < wordsPerRow; ++i) {
+            row[i] = counterrng::bernoulliWord(seed, rowStart + i, threshold);
         }
-    }
+    }, threads);
 }
 
 void PatternManager::clearGrid(Grid& grid) {
     grid.clear();
 }
 
+// Registering never replaces an existing pattern, built-ins included
 void PatternManager::registerPattern(const std::string& name, const Pattern& pattern) {
+    if (hasPattern(name)) return;
     patterns.insert(std::make_pair(name, pattern));
 }
 
 void PatternManager::registerPattern(const std::string& name, const std::string& description,
                                    const std::vector<std::vector<bool>>& cells) {
+    if (hasPattern(name)) return;
     patterns.emplace(name, Pattern(name, description, cells));
 }
 
 bool PatternManager::hasPattern(const std::string& name) const {
-    return patterns.find(name) != patterns.end();
+    return patterns.find(name) != patterns.end() || macrocellPatterns.find(name) != macrocellPatterns.end() ||
+           findBuiltIn(name) != nullptr || library.find(name) != nullptr;
 }
 
 std::vector<std::string> PatternManager::getPatternNames() const {
@@ -71,23 +283,82 @@ std::vector<std::string> PatternManager::getPatternNames() const {
     for (const auto& pair : patterns) {
         names.push_back(pair.first);
     }
+    for (const auto& pair : macrocellPatterns) {
+        names.push_back(pair.first);
+    }
+    for (const BuiltInPattern& pattern : BUILT_IN_PATTERNS) {
+        if (patterns.find(pattern.name) == patterns.end() &&
+            macrocellPatterns.find(pattern.name) == macrocellPatterns.end()) {
+            names.push_back(pattern.name);
+        }
+    }
+    std::sort(names.begin(), names.end());
     return names;
 }
 
 const Pattern& PatternManager::getPattern(const std::string& name) const {
     auto it = patterns.find(name);
-    if (it == patterns.end()) {
-        throw std::invalid_argument("Pattern not found: " + name);
+    if (it != patterns.end()) {
+        return it->second;
+    }
+
+    // Loading checked that the box fits in a pattern bitmap
+    auto macrocell = macrocellPatterns.find(name);
+    if (macrocell != macrocellPatterns.end()) {
+        auto flattened = flattenedPatterns.find(name);
+        if (flattened != flattenedPatterns.end()) {
+            return flattened->second;
+        }
+        const MacrocellPattern& loaded = macrocell->second;
+        Pattern pattern(name, "", static_cast<unsigned int>(loaded.width), static_cast<unsigned int>(loaded.height));
+        pattern.rule = LifeRule().toString();
+        loaded.tree->forEachLeaf([&pattern, &loaded](int64_t x, int64_t y, uint64_t bits) {
+            while (bits) {
+                int bit = bitops::countTrailingZeros(bits);
+                bits &= bits - 1;
+                pattern.setCell(static_cast<unsigned int>(x + bit % QuadTree::LEAF_SIZE - loaded.minX),
+                                static_cast<unsigned int>(y + bit / QuadTree::LEAF_SIZE - loaded.minY), true);
+            }
+        });
+        return flattenedPatterns.emplace(name, std::move(pattern)).first->second;
+    }
+
+    auto cached = builtInPatterns.find(name);
+    if (cached != builtInPatterns.end()) {
+        return cached->second;
+    }
+    const BuiltInPattern* builtIn = findBuiltIn(name);
+    if (builtIn) {
+        Pattern pattern(builtIn->name, builtIn->description, builtIn->width, builtIn->height, builtIn->rows);
+        pattern.rule = builtIn->rule.toString();
+        return builtInPatterns.emplace(name, std::move(pattern)).first->second;
+    }
+
+    // Decoded (or taken from the library's cache) only now, and held until
+    // the next library pattern so the reference outlives cache evictions
+    if (library.find(name)) {
+        std::shared_ptr<const Pattern> pattern = library.load(name);
+        if (!pattern) {
+            throw std::invalid_argument("Cannot load pattern " + name + ": " + library.getError());
+        }
+        if (!isSupportedRule(pattern->rule)) {
+            throw std::invalid_argument(unsupportedRuleError(name, pattern->rule));
+        }
+        libraryPattern = pattern;
+        return *libraryPattern;
     }
-    return it->second;
+    throw std::invalid_argument("Pattern not found: " + name);
 }
 
-void PatternManager::initializeBuiltInPatterns() {
-    registerPattern("glider", createGliderPattern());
-    registerPattern("beacon", createBeaconPattern());
-    registerPattern("blinker", createBlinkerPattern());
-    registerPattern("toad", createToadPattern());
-    registerPattern("test", createTestPattern());
+bool PatternManager::openLibrary(const std::string& directory) {
+    auto start = std::chrono::steady_clock::now();
+    libraryPattern.reset();
+    bool opened = library.open(directory);
+
+    lastLoadStats = PatternLoadStats();
+    lastLoadStats.error = library.getError();
+    lastLoadStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return opened;
 }
 
 void PatternManager::applyPatternAt(Grid& grid, const std::string& patternName,
@@ -96,6 +367,12 @@ void PatternManager::applyPatternAt(Grid& grid, const std::string& patternName,
         throw std::invalid_argument("Pattern not found: " + patternName);
     }
 
+    auto macrocell = macrocellPatterns.find(patternName);
+    if (macrocell != macrocellPatterns.end()) {
+        placeMacrocell(grid, patternName, macrocell->second, startX, startY, false);
+        return;
+    }
+
     const Pattern& pattern = getPattern(patternName);
 
     if (!canFitPattern(grid, pattern, startX, startY)) {
@@ -110,133 +387,169 @@ void PatternManager::applyPatternCentered(Grid& grid, const std::string& pattern
         throw std::invalid_argument("Pattern not found: " + patternName);
     }
 
+    auto macrocell = macrocellPatterns.find(patternName);
+    if (macrocell != macrocellPatterns.end()) {
+        const MacrocellPattern& loaded = macrocell->second;
+        unsigned int left = loaded.width < grid.getWidth() ? (grid.getWidth() - loaded.width) / 2 : 0;
+        unsigned int top = loaded.height < grid.getHeight() ? (grid.getHeight() - loaded.height) / 2 : 0;
+        placeMacrocell(grid, patternName, loaded, left, top, false);
+        return;
+    }
+
     const Pattern& pattern = getPattern(patternName);
     auto centerPos = calculateCenterPosition(grid, pattern);
     placePattern(grid, pattern, centerPos.first, centerPos.second);
 }
 
-Pattern PatternManager::createGliderPattern() {
-    std::vector<std::vector<bool>> glider = {
-        {false, true, false},
-        {false, false, true},
-        {true, true, true}
-    };
-
-    return Pattern("glider", "Classic glider pattern that moves diagonally", glider);
+bool PatternManager::canFitPattern(const Grid& grid, const Pattern& pattern,
+                                  unsigned int startX, unsigned int startY) const {
+    return (startX + pattern.width <= grid.getWidth() &&
+            startY + pattern.height <= grid.getHeight());
 }
 
-Pattern PatternManager::createBeaconPattern() {
-    std::vector<std::vector<bool>> beacon = {
-        {true, true, false, false},
-        {true, true, false, false},
-        {false, false, true, true},
-        {false, false, true, true}
-    };
-
-    return Pattern("beacon", "Oscillating beacon pattern with period 2", beacon);
-}
+std::pair<unsigned int, unsigned int> PatternManager::calculateCenterPosition(
+    const Grid& grid, const Pattern& pattern) const {
 
-Pattern PatternManager::createBlinkerPattern() {
-    std::vector<std::vector<bool>> blinker = {
-        {true, true, true}
-    };
+    // Patterns larger than the grid are anchored at the top-left corner and clipped
+    unsigned int centerX = pattern.width < grid.getWidth() ? (grid.getWidth() - pattern.width) / 2 : 0;
+    unsigned int centerY = pattern.height < grid.getHeight() ? (grid.getHeight() - pattern.height) / 2 : 0;
 
-    return Pattern("blinker", "Simple oscillating pattern with period 2", blinker);
+    return std::make_pair(centerX, centerY);
 }
 
-Pattern PatternManager::createToadPattern() {
-    std::vector<std::vector<bool>> toad = {
-        {false, true, true, true},
-        {true, true, true, false}
-    };
-
-    return Pattern("toad", "Oscillating toad pattern with period 2", toad);
+void PatternManager::placePattern(Grid& grid, const Pattern& pattern,
+                                 unsigned int startX, unsigned int startY) {
+    grid.blit(pattern.rows.data(), pattern.wordsPerRow, pattern.width, pattern.height,
+              startX, startY, Grid::BlitMode::Or);
 }
 
-Pattern PatternManager::createGliderGunPattern() {
-    // This is a simplified version - the full Gosper glider gun is quite large
-    std::vector<std::vector<bool>> gun(9, std::vector<bool>(36, false));
-
-    // Left block
-    gun[5][1] = gun[5][2] = gun[6][1] = gun[6][2] = true;
-
-    // Left oscillator
-    gun[3][13] = gun[3][14] = gun[4][12] = gun[4][16] = gun[5][11] = gun[5][17] = true;
-    gun[6][11] = gun[6][15] = gun[6][17] = gun[6][18] = gun[7][11] = gun[7][17] = true;
-    gun[8][12] = gun[8][16] = gun[9][13] = gun[9][14] = true;
-
-    // Right block
-    gun[3][25] = gun[4][23] = gun[4][25] = gun[5][21] = gun[5][22] = true;
-    gun[6][21] = gun[6][22] = gun[7][21] = gun[7][22] = gun[8][23] = gun[8][25] = gun[9][25] = true;
-
-    // Right block
-    gun[1][35] = gun[1][36] = gun[2][35] = gun[2][36] = true;
+void PatternManager::placeMacrocell(Grid& grid, const std::string& name, const MacrocellPattern& macrocell,
+                                    unsigned int startX, unsigned int startY, bool replace) {
+    if (startX > grid.getWidth() || startY > grid.getHeight() ||
+        macrocell.width > grid.getWidth() - startX || macrocell.height > grid.getHeight() - startY) {
+        lastLoadStats.error = name + " spans " + std::to_string(macrocell.width) + "x" +
+                              std::to_string(macrocell.height) + " cells and does not fit in the " +
+                              std::to_string(grid.getWidth()) + "x" + std::to_string(grid.getHeight()) + " grid";
+        throw std::invalid_argument(lastLoadStats.error);
+    }
 
-    return Pattern("glider_gun", "Gosper glider gun - creates gliders", gun);
+    if (replace) {
+        clearGrid(grid);
+    }
+    macrocell.tree->flattenInto(grid, static_cast<int64_t>(startX) - macrocell.minX,
+                                static_cast<int64_t>(startY) - macrocell.minY);
 }
 
-Pattern PatternManager::createTestPattern() {
-    // Create a test pattern similar to the original seedTestPattern
-    std::vector<std::vector<bool>> test(20, std::vector<bool>(20, false));
-
-    // Corner markers
-    test[0][0] = test[0][19] = test[19][0] = test[19][19] = true;
+bool PatternManager::loadPatternFromFile(const std::string& filename, const Grid* target) {
+    if (filename.size() > 3 && filename.compare(filename.size() - 3, 3, ".mc") == 0) {
+        return loadMacrocellPattern(filename, target);
+    }
 
-    // Center cross
-    unsigned int centerX = 10;
-    unsigned int centerY = 10;
-    for (int i = -2; i <= 2; ++i) {
-        if (centerX + i < 20) {
-            test[centerY][centerX + i] = true;
-        }
-        if (centerY + i >= 0 && centerY + i < 20) {
-            test[centerY + i][centerX] = true;
-        }
+    RleReader reader;
+    std::unique_ptr<Pattern> pattern;
+    std::string allocationError;
+    try {
+        pattern = reader.read(filename);
+    } catch (const std::bad_alloc&) {
+        allocationError = "Not enough memory to load " + filename;
     }
 
-    // Border markers
-    for (unsigned int x = 0; x < 20; x += 5) {
-        test[0][x] = test[19][x] = true;
+    lastLoadStats = PatternLoadStats();
+    lastLoadStats.error = allocationError.empty() ? reader.getError() : allocationError;
+    lastLoadStats.bytesRead = reader.getBytesRead();
+    lastLoadStats.seconds = reader.getSeconds();
+    lastLoadStats.megabytesPerSecond = reader.getThroughputMBps();
+
+    if (!pattern) {
+        return false;
     }
-    for (unsigned int y = 0; y < 20; y += 5) {
-        test[y][0] = test[y][19] = true;
+    if (!isSupportedRule(pattern->rule)) {
+        lastLoadStats.error = unsupportedRuleError(filename, pattern->rule);
+        return false;
     }
 
-    return Pattern("test", "Test pattern for coordinate verification", test);
+    lastLoadStats.patternName = pattern->name;
+    macrocellPatterns.erase(pattern->name);
+    flattenedPatterns.erase(pattern->name);
+    patterns.insert_or_assign(pattern->name, std::move(*pattern));
+    return true;
 }
 
-bool PatternManager::canFitPattern(const Grid& grid, const Pattern& pattern,
-                                  unsigned int startX, unsigned int startY) const {
-    return (startX + pattern.width <= grid.getWidth() &&
-            startY + pattern.height <= grid.getHeight());
+bool PatternManager::savePatternToFile(const std::string& patternName, const std::string& filename) const {
+    if (!hasPattern(patternName)) {
+        return false;
+    }
+
+    RleWriter writer;
+    return writer.writePattern(getPattern(patternName), filename);
 }
 
-std::pair<unsigned int, unsigned int> PatternManager::calculateCenterPosition(
-    const Grid& grid, const Pattern& pattern) const {
+bool PatternManager::loadMacrocell(const std::string& filename, QuadTree& tree) {
+    auto start = std::chrono::steady_clock::now();
+    MacrocellFile file;
+    bool loaded = file.read(filename, tree);
+
+    lastLoadStats = PatternLoadStats();
+    lastLoadStats.error = file.getError();
+    lastLoadStats.bytesRead = file.getBytesRead();
+    lastLoadStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (lastLoadStats.seconds > 0.0) {
+        lastLoadStats.megabytesPerSecond = (lastLoadStats.bytesRead / (1024.0 * 1024.0)) / lastLoadStats.seconds;
+    }
+    if (loaded && !isSupportedRule(file.getRule())) {
+        lastLoadStats.error = unsupportedRuleError(filename, file.getRule());
+        return false;
+    }
+    return loaded;
+}
 
-    unsigned int centerX = (grid.getWidth() - pattern.width) / 2;
-    unsigned int centerY = (grid.getHeight() - pattern.height) / 2;
+bool PatternManager::saveMacrocell(const Grid& grid, const std::string& filename) const {
+    QuadTree tree;
+    tree.buildFromGrid(grid);
 
-    return std::make_pair(centerX, centerY);
+    MacrocellFile file;
+    file.setGeneration(grid.getGeneration());
+    return file.write(tree, filename);
 }
 
-void PatternManager::placePattern(Grid& grid, const Pattern& pattern,
-                                 unsigned int startX, unsigned int startY) {
-    for (unsigned int y = 0; y < pattern.height; ++y) {
-        for (unsigned int x = 0; x < pattern.width; ++x) {
-            if (pattern.cells[y][x]) {
-                grid.setCell(startX + x, startY + y, true);
-            }
-        }
+bool PatternManager::loadMacrocellPattern(const std::string& filename, const Grid* target) {
+    auto tree = std::make_shared<QuadTree>();
+    if (!loadMacrocell(filename, *tree)) {
+        return false;
     }
-}
 
-bool PatternManager::loadPatternFromFile(const std::string& filename) {
-    // TODO: Implement file loading functionality
-    return false;
+    // Only the box is measured here, in O(distinct nodes); cells are stamped
+    // from the tree when the pattern is applied
+    QuadTree::Bounds bounds = tree->getBounds();
+    MacrocellPattern macrocell;
+    macrocell.minX = bounds.empty() ? 0 : bounds.minX;
+    macrocell.minY = bounds.empty() ? 0 : bounds.minY;
+    macrocell.width = bounds.empty() ? 0 : static_cast<uint64_t>(bounds.maxX - bounds.minX + 1);
+    macrocell.height = bounds.empty() ? 0 : static_cast<uint64_t>(bounds.maxY - bounds.minY + 1);
+
+    const uint64_t maxWidth = target ? target->getWidth() : RleReader::MAX_DIMENSION;
+    const uint64_t maxHeight = target ? target->getHeight() : RleReader::MAX_DIMENSION;
+    if (macrocell.width > maxWidth || macrocell.height > maxHeight) {
+        lastLoadStats.error = filename + " spans " + std::to_string(macrocell.width) + "x" +
+                              std::to_string(macrocell.height) + " cells, more than the " +
+                              std::to_string(maxWidth) + "x" + std::to_string(maxHeight) +
+                              (target ? " grid" : " a pattern can hold");
+        return false;
+    }
+    macrocell.tree = std::move(tree);
+
+    size_t slash = filename.find_last_of("/\\");
+    std::string name = filename.substr(slash == std::string::npos ? 0 : slash + 1);
+    name = name.substr(0, name.size() - 3);
+
+    lastLoadStats.patternName = name;
+    patterns.erase(name);
+    flattenedPatterns.erase(name);
+    macrocellPatterns.insert_or_assign(name, std::move(macrocell));
+    return true;
 }
 
-bool PatternManager::savePatternToFile(const std::string& patternName, const std::string& filename) const {
-    // TODO: Implement file saving functionality
-    return false;
+bool PatternManager::saveGridToFile(const Grid& grid, const std::string& filename) const {
+    RleWriter writer;
+    return writer.writeGrid(grid, filename);
 }
@@ -1,22 +1,50 @@
 #ifndef PATTERNMANAGER_HPP
 #define PATTERNMANAGER_HPP
 
+#include "PatternLibrary.hpp"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
 // Forward declarations
 class Grid;
+class QuadTree;
 
+// Pattern cells are stored as packed rows with the same bit layout as Grid
+// (cell x lives in bit x % 64 of word x / 64), so placing one is a word blit
 struct Pattern {
     std::string name;
     std::string description;
-    std::vector<std::vector<bool>> cells;
+    std::string rule;
     unsigned int width;
     unsigned int height;
+    unsigned int wordsPerRow;
+    std::vector<uint64_t> rows;
 
     Pattern(const std::string& name, const std::string& desc,
             const std::vector<std::vector<bool>>& pattern);
+    Pattern(const std::string& name, const std::string& desc,
+            unsigned int width, unsigned int height);
+    // Copies packed rows laid out as above
+    Pattern(const std::string& name, const std::string& desc,
+            unsigned int width, unsigned int height, const uint64_t* rows);
+
+    bool getCell(unsigned int x, unsigned int y) const;
+    void setCell(unsigned int x, unsigned int y, bool alive);
+    void setRun(unsigned int x, unsigned int y, unsigned int count); // Sets `count` live cells from x
+    const uint64_t* getRow(unsigned int y) const { return rows.data() + static_cast<size_t>(y) * wordsPerRow; }
+    uint64_t* getRow(unsigned int y) { return rows.data() + static_cast<size_t>(y) * wordsPerRow; }
+};
+
+// Outcome of the most recent pattern file load
+struct PatternLoadStats {
+    std::string patternName;
+    std::string error;
+    uint64_t bytesRead = 0;
+    double seconds = 0.0;
+    double megabytesPerSecond = 0.0;
 };
 
 class PatternManager {
@@ -25,39 +53,76 @@ public:
 
     // Pattern application methods
     void applyPattern(Grid& grid, const std::string& patternName);
+    // Fills the whole grid with cells alive at `density`. The same seed always
+    // gives the same universe, regardless of how many threads generate it;
+    // without a seed, the one set by setRandomSeed is used once, after which
+    // seeds are drawn from std::random_device (see getLastRandomSeed)
     void applyRandomPattern(Grid& grid, float density = 0.3f);
+    void applyRandomPattern(Grid& grid, float density, uint64_t seed, unsigned int threads = 0);
+    void setRandomSeed(uint64_t seed) { pendingRandomSeed = seed; hasPendingRandomSeed = true; }
+    uint64_t getLastRandomSeed() const { return lastRandomSeed; }
     void clearGrid(Grid& grid);
 
     // Pattern registration and management
     void registerPattern(const std::string& name, const Pattern& pattern);
     void registerPattern(const std::string& name, const std::string& description,
                         const std::vector<std::vector<bool>>& cells);
+    // Built-in patterns are compile-time bitmaps, turned into a Pattern the
+    // first time getPattern asks for one; a loaded pattern of the same name
+    // takes precedence, and library patterns come last
     bool hasPattern(const std::string& name) const;
+    // Registered and built-in patterns; library entries are listed by getLibrary()
     std::vector<std::string> getPatternNames() const;
+    // A library pattern stays valid until the next getPattern of another one
     const Pattern& getPattern(const std::string& name) const;
 
-    // Built-in patterns
-    void initializeBuiltInPatterns();
+    // Serves the .rle files under a directory by name, decoding each only
+    // when it is applied (see PatternLibrary)
+    bool openLibrary(const std::string& directory);
+    const PatternLibrary& getLibrary() const { return library; }
 
     // Pattern positioning
     void applyPatternAt(Grid& grid, const std::string& patternName,
                        unsigned int startX, unsigned int startY);
     void applyPatternCentered(Grid& grid, const std::string& patternName);
 
-    // Pattern file I/O (for future expansion)
-    bool loadPatternFromFile(const std::string& filename);
+    // Pattern file I/O. A loaded pattern is registered under its #N name
+    // (or the file name), replacing any pattern with the same name. Patterns
+    // whose rule is not B3/S23 are refused. Macrocell (.mc) files stay
+    // quadtrees and are stamped into the grid they are applied to, so their
+    // live cells must fit in `target` (or, without one, in the largest
+    // pattern bitmap, RleReader::MAX_DIMENSION per side).
+    bool loadPatternFromFile(const std::string& filename, const Grid* target = nullptr);
     bool savePatternToFile(const std::string& patternName, const std::string& filename) const;
+    bool saveGridToFile(const Grid& grid, const std::string& filename) const;
+    const PatternLoadStats& getLastLoadStats() const { return lastLoadStats; }
+
+    // Macrocell I/O for universes too large to flatten; the tree can be
+    // stamped into a Grid on demand with QuadTree::flattenInto. Saving
+    // records the grid's generation.
+    bool loadMacrocell(const std::string& filename, QuadTree& tree);
+    bool saveMacrocell(const Grid& grid, const std::string& filename) const;
 
 private:
-    std::map<std::string, Pattern> patterns;
+    // A loaded macrocell universe and the bounding box of its live cells
+    struct MacrocellPattern {
+        std::shared_ptr<const QuadTree> tree;
+        int64_t minX;
+        int64_t minY;
+        uint64_t width;
+        uint64_t height;
+    };
 
-    // Built-in pattern creation methods
-    Pattern createGliderPattern();
-    Pattern createBeaconPattern();
-    Pattern createBlinkerPattern();
-    Pattern createToadPattern();
-    Pattern createGliderGunPattern();
-    Pattern createTestPattern();
+    std::map<std::string, Pattern> patterns;
+    std::map<std::string, MacrocellPattern> macrocellPatterns;
+    mutable std::map<std::string, Pattern> flattenedPatterns;  // Macrocells asked for by getPattern
+    mutable std::map<std::string, Pattern> builtInPatterns;   // Built-ins used so far
+    mutable PatternLibrary library;
+    mutable std::shared_ptr<const Pattern> libraryPattern;    // Last one handed out
+    PatternLoadStats lastLoadStats;
+    uint64_t lastRandomSeed = 0;
+    uint64_t pendingRandomSeed = 0;
+    bool hasPendingRandomSeed = false;
 
     // Helper methods
     bool canFitPattern(const Grid& grid, const Pattern& pattern,
@@ -66,6 +131,12 @@ private:
         const Grid& grid, const Pattern& pattern) const;
     void placePattern(Grid& grid, const Pattern& pattern,
                      unsigned int startX, unsigned int startY);
+    bool loadMacrocellPattern(const std::string& filename, const Grid* target);
+    // Stamps a macrocell pattern with its box at (startX, startY), clearing
+    // the grid first if `replace`. Throws std::invalid_argument (also left in
+    // lastLoadStats.error) if the box does not fit in the grid there.
+    void placeMacrocell(Grid& grid, const std::string& name, const MacrocellPattern& macrocell,
+                        unsigned int startX, unsigned int startY, bool replace);
 };
 
 #endif // PATTERNMANAGER_HPP
@@ -0,0 +1,261 @@
+#include "RleReader.hpp"
+#include "PatternManager.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string fileStem(const std::string& filename) {
+    size_t slash = filename.find_last_of("/\\");
+    std::string base = slash == std::string::npos ? filename : filename.substr(slash + 1);
+    size_t dot = base.find_last_of('.');
+    return dot == std::string::npos ? base : base.substr(0, dot);
+}
+
+} // namespace
+
+RleReader::RleReader(size_t chunkSize)
+    : chunkSize(std::max<size_t>(chunkSize, 64)), bytesRead(0), seconds(0.0) {
+    reset();
+}
+
+double RleReader::getThroughputMBps() const {
+    return seconds > 0.0 ? (bytesRead / (1024.0 * 1024.0)) / seconds : 0.0;
+}
+
+void RleReader::reset() {
+    error.clear();
+    bytesRead = 0;
+    seconds = 0.0;
+    state = State::Header;
+    line.clear();
+    patternName.clear();
+    description.clear();
+    pattern.reset();
+    runCount = 0;
+    cursorX = 0;
+    cursorY = 0;
+    countOnly = false;
+    info = RleInfo();
+}
+
+std::unique_ptr<Pattern> RleReader::read(const std::string& filename) {
+    reset();
+    if (!readFrom(filename, 0)) {
+        return nullptr;
+    }
+
+    pattern->name = patternName.empty() ? fileStem(filename) : patternName;
+    pattern->description = description;
+    return std::move(pattern);
+}
+
+bool RleReader::scan(const std::string& filename, RleInfo& result) {
+    reset();
+    countOnly = true;
+    if (!readFrom(filename, 0)) {
+        return false;
+    }
+
+    info.name = patternName.empty() ? fileStem(filename) : patternName;
+    info.description = description;
+    result = info;
+    return true;
+}
+
+std::unique_ptr<Pattern> RleReader::read(const std::string& filename, const RleInfo& known) {
+    reset();
+    info = known;
+    pattern = std::make_unique<Pattern>(known.name, known.description, known.width, known.height);
+    pattern->rule = known.rule;
+    state = State::Body;
+    if (!readFrom(filename, known.bodyOffset)) {
+        return nullptr;
+    }
+    return std::move(pattern);
+}
+
+bool RleReader::readFrom(const std::string& filename, uint64_t offset) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+    if (offset > 0 && !file.seekg(static_cast<std::streamoff>(offset))) {
+        error = "Cannot seek to offset " + std::to_string(offset) + " in " + filename;
+        return false;
+    }
+    // Counted from the start of the file, so consume() sees absolute offsets
+    bytesRead = offset;
+
+    std::vector<char> chunk(chunkSize);
+    while (state != State::Done && error.empty() && file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        size_t count = static_cast<size_t>(file.gcount());
+        if (count == 0) break;
+
+        bytesRead += count;
+        consume(chunk.data(), count);
+    }
+
+    // A trailing header line without a newline still counts
+    if (error.empty() && state == State::Header && !line.empty()) {
+        handleHeaderLine(line);
+        info.bodyOffset = bytesRead;
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (error.empty() && state == State::Header) {
+        error = "Missing 'x = ..., y = ...' header in " + filename;
+    }
+    return error.empty();
+}
+
+void RleReader::consume(const char* data, size_t size) {
+    for (size_t i = 0; i < size && state != State::Done && error.empty(); ++i) {
+        char c = data[i];
+
+        switch (state) {
+            case State::Header:
+                if (c == '\n') {
+                    handleHeaderLine(line);
+                    line.clear();
+                    // The body starts right after the dimensions line
+                    info.bodyOffset = bytesRead - size + i + 1;
+                } else {
+                    line.push_back(c);
+                }
+                break;
+
+            case State::Comment:
+                if (c == '\n') {
+                    state = State::Body;
+                }
+                break;
+
+            case State::Body:
+                if (c >= '0' && c <= '9') {
+                    runCount = runCount * 10 + static_cast<uint64_t>(c - '0');
+                    if (runCount > 0xFFFFFFFFULL) {
+                        error = "Run count overflow";
+                    }
+                } else if (c == '!') {
+                    state = State::Done;
+                } else if (c == '#') {
+                    state = State::Comment;
+                } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '$') {
+                    applyRun(c);
+                }
+                // Whitespace and line breaks between runs are insignificant
+                break;
+
+            case State::Done:
+                break;
+        }
+    }
+}
+
+bool RleReader::handleHeaderLine(const std::string& headerLine) {
+    std::string text = trim(headerLine);
+    if (text.empty()) return true;
+
+    if (text[0] == '#') {
+        if (text.size() > 1 && (text[1] == 'N')) {
+            patternName = trim(text.substr(2));
+        } else if (text.size() > 1 && (text[1] == 'C' || text[1] == 'c') && description.empty()) {
+            description = trim(text.substr(2));
+        }
+        return true;
+    }
+
+    if (text[0] == 'x') {
+        if (!parseDimensions(text)) {
+            return false;
+        }
+        state = State::Body;
+        return true;
+    }
+
+    error = "Unexpected line before header: " + text;
+    return false;
+}
+
+bool RleReader::parseDimensions(const std::string& headerLine) {
+    unsigned long long width = 0;
+    unsigned long long height = 0;
+    std::string rule = "B3/S23";
+
+    std::stringstream fields(headerLine);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        size_t equals = field.find('=');
+        if (equals == std::string::npos) continue;
+
+        std::string key = trim(field.substr(0, equals));
+        std::string value = trim(field.substr(equals + 1));
+        if (key == "x") {
+            width = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "y") {
+            height = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "rule") {
+            rule = value;
+        }
+    }
+
+    // "x = 0, y = 0" is how an empty universe is written, so zero is allowed
+    if (width > MAX_DIMENSION || height > MAX_DIMENSION) {
+        error = "Pattern is " + std::to_string(width) + "x" + std::to_string(height) +
+                ", larger than the " + std::to_string(MAX_DIMENSION) + " cells per side supported";
+        return false;
+    }
+
+    info.width = static_cast<unsigned int>(width);
+    info.height = static_cast<unsigned int>(height);
+    info.rule = rule;
+    if (!countOnly) {
+        pattern = std::make_unique<Pattern>("", "", info.width, info.height);
+        pattern->rule = rule;
+    }
+    return true;
+}
+
+void RleReader::applyRun(char tag) {
+    unsigned int count = runCount == 0 ? 1 : static_cast<unsigned int>(runCount);
+    runCount = 0;
+
+    const unsigned int width = info.width;
+    const unsigned int clipped = std::min(count, width - std::min(cursorX, width));
+    if (tag == '$') {
+        // Saturates at the declared height, so a huge run cannot wrap back
+        // onto the first rows
+        const unsigned int height = info.height;
+        cursorY = count > height - std::min(cursorY, height) ? height : cursorY + count;
+        cursorX = 0;
+    } else if (tag == 'b' || tag == '.') {
+        cursorX += clipped;
+    } else {
+        // 'o' and any multi-state letter are treated as live; cells past the
+        // declared bounds are clipped
+        if (countOnly) {
+            info.population += cursorY < info.height ? clipped : 0;
+        } else {
+            pattern->setRun(cursorX, cursorY, count);
+        }
+        cursorX += clipped;
+    }
+}
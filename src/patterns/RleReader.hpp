@@ -0,0 +1,76 @@
+#ifndef RLEREADER_HPP
+#define RLEREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct Pattern;
+
+// What an index needs to know about an RLE file without decoding it
+struct RleInfo {
+    std::string name;
+    std::string description;
+    std::string rule;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    uint64_t population = 0;    // Live cells within the declared bounds
+    uint64_t bodyOffset = 0;    // Byte offset of the first run after the header
+};
+
+// Streaming reader for the run-length encoded (.rle) pattern format.
+// The file is consumed in fixed-size chunks and runs are decoded straight into
+// the pattern's packed rows, so memory stays at one chunk plus the bitmap.
+class RleReader {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+    // Largest side a header may declare; the bitmap is allocated up front,
+    // and this keeps it within what a Grid of that size needs (512 MB)
+    static constexpr unsigned int MAX_DIMENSION = 1u << 16;
+
+    explicit RleReader(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Returns nullptr and records an error message on failure
+    std::unique_ptr<Pattern> read(const std::string& filename);
+    // Parses the header and counts live cells without allocating the bitmap
+    bool scan(const std::string& filename, RleInfo& info);
+    // Decodes a file already scanned, starting at info.bodyOffset
+    std::unique_ptr<Pattern> read(const std::string& filename, const RleInfo& info);
+
+    // Diagnostics for the last read
+    const std::string& getError() const { return error; }
+    uint64_t getBytesRead() const { return bytesRead; }
+    double getSeconds() const { return seconds; }
+    double getThroughputMBps() const;
+
+private:
+    enum class State { Header, Body, Comment, Done };
+
+    size_t chunkSize;
+    std::string error;
+    uint64_t bytesRead;
+    double seconds;
+
+    // Parser state carried across chunk boundaries
+    State state;
+    std::string line;
+    std::string patternName;
+    std::string description;
+    std::unique_ptr<Pattern> pattern;
+    uint64_t runCount;
+    unsigned int cursorX;
+    unsigned int cursorY;
+    // Scan mode: runs are counted instead of decoded
+    bool countOnly;
+    RleInfo info;
+
+    void reset();
+    bool readFrom(const std::string& filename, uint64_t offset);
+    void consume(const char* data, size_t size);
+    bool handleHeaderLine(const std::string& headerLine);
+    bool parseDimensions(const std::string& headerLine);
+    void applyRun(char tag);
+};
+
+#endif // RLEREADER_HPP
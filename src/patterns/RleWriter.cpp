@@ -0,0 +1,176 @@
+#include "RleWriter.hpp"
+#include "PatternManager.hpp"
+#include "../core/Grid.hpp"
+#include "../core/BitOps.hpp"
+#include <algorithm>
+
+namespace {
+
+// First cell at or after `from` whose state matches `live`, or `width` if none
+unsigned int findNext(const uint64_t* row, unsigned int from, unsigned int width, bool live) {
+    unsigned int words = (width + 63) / 64;
+    for (unsigned int i = from / 64; i < words; ++i) {
+        uint64_t word = live ? row[i] : ~row[i];
+        if (i == from / 64) {
+            word &= ~bitops::lowMask(from % 64);
+        }
+        if (word) {
+            return std::min(width, i * 64 + bitops::countTrailingZeros(word));
+        }
+    }
+    return width;
+}
+
+} // namespace
+
+RleWriter::RleWriter() : lineLength(0), bytesWritten(0) {
+    buffer.reserve(BUFFER_SIZE);
+}
+
+bool RleWriter::writeGrid(const Grid& grid, const std::string& filename, const std::string& name) {
+    return writeRows(filename, name, "", "B3/S23", grid.getWidth(), grid.getHeight(),
+                     [&grid](unsigned int y) { return grid.getRow(y); });
+}
+
+bool RleWriter::writePattern(const Pattern& pattern, const std::string& filename) {
+    return writeRows(filename, pattern.name, pattern.description, pattern.rule, pattern.width, pattern.height,
+                     [&pattern](unsigned int y) { return pattern.getRow(y); });
+}
+
+bool RleWriter::writeRows(const std::string& filename, const std::string& name, const std::string& description,
+                          const std::string& rule, unsigned int width, unsigned int height,
+                          const std::function<const uint64_t*(unsigned int)>& rowAt) {
+    error.clear();
+    bytesWritten = 0;
+    lineLength = 0;
+    buffer.clear();
+
+    // Bounding box of live cells: OR of all rows gives the columns in use
+    unsigned int words = (width + 63) / 64;
+    std::vector<uint64_t> columns(words, 0);
+    unsigned int top = height;
+    unsigned int bottom = 0;
+    for (unsigned int y = 0; y < height; ++y) {
+        const uint64_t* row = rowAt(y);
+        uint64_t any = 0;
+        for (unsigned int i = 0; i < words; ++i) {
+            columns[i] |= row[i];
+            any |= row[i];
+        }
+        if (any) {
+            top = std::min(top, y);
+            bottom = y;
+        }
+    }
+
+    unsigned int left = top < height ? findNext(columns.data(), 0, width, true) : 0;
+    unsigned int right = left;
+    for (unsigned int i = words; i-- > 0;) {
+        if (columns[i]) {
+            right = i * 64 + static_cast<unsigned int>(bitops::highestSetBit(columns[i]));
+            break;
+        }
+    }
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    if (!name.empty()) {
+        writeText("#N " + name + "\n");
+    }
+    if (!description.empty()) {
+        writeText("#C " + description + "\n");
+    }
+
+    unsigned int boxWidth = top < height ? right - left + 1 : 0;
+    unsigned int boxHeight = top < height ? bottom - top + 1 : 0;
+    writeText("x = " + std::to_string(boxWidth) + ", y = " + std::to_string(boxHeight) +
+              ", rule = " + rule + "\n");
+    lineLength = 0;
+
+    uint64_t pendingRows = 0;
+    for (unsigned int y = top; y <= bottom && y < height; ++y) {
+        const uint64_t* row = rowAt(y);
+        unsigned int x = left;
+        bool rowStarted = false;
+
+        while (x <= right) {
+            unsigned int start = findNext(row, x, right + 1, true);
+            if (start > right) break;
+            unsigned int end = findNext(row, start, right + 1, false);
+
+            if (!rowStarted) {
+                if (pendingRows > 0) {
+                    writeRun(pendingRows, '$');
+                    pendingRows = 0;
+                }
+                rowStarted = true;
+            }
+            if (start > x) {
+                writeRun(start - x, 'b');
+            }
+            writeRun(end - start, 'o');
+            x = end;
+        }
+
+        ++pendingRows;
+    }
+
+    writeText("!\n");
+    flush();
+    file.close();
+
+    if (!file) {
+        error = "Failed writing " + filename;
+        return false;
+    }
+    return true;
+}
+
+void RleWriter::writeText(const std::string& text) {
+    buffer.insert(buffer.end(), text.begin(), text.end());
+    if (buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void RleWriter::writeRun(uint64_t count, char tag) {
+    char token[24];
+    size_t length = 0;
+
+    if (count > 1) {
+        char digits[20];
+        size_t digitCount = 0;
+        while (count > 0) {
+            digits[digitCount++] = static_cast<char>('0' + count % 10);
+            count /= 10;
+        }
+        while (digitCount > 0) {
+            token[length++] = digits[--digitCount];
+        }
+    }
+    token[length++] = tag;
+
+    // Runs are never split across lines, which keep under the usual 70 columns
+    if (lineLength + length > MAX_LINE_LENGTH) {
+        buffer.push_back('\n');
+        lineLength = 0;
+    }
+    buffer.insert(buffer.end(), token, token + length);
+    lineLength += length;
+
+    if (buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void RleWriter::flush() {
+    if (!buffer.empty() && file) {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        bytesWritten += buffer.size();
+    }
+    buffer.clear();
+}
@@ -0,0 +1,46 @@
+#ifndef RLEWRITER_HPP
+#define RLEWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Grid;
+struct Pattern;
+
+// Writes packed rows as run-length encoded (.rle) text. Runs are found with
+// count-trailing-zeros on whole words and streamed through a fixed buffer,
+// so no intermediate copy of the cells is ever built.
+class RleWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    static constexpr size_t MAX_LINE_LENGTH = 70;
+
+    RleWriter();
+
+    // The pattern is cropped to the bounding box of its live cells
+    bool writeGrid(const Grid& grid, const std::string& filename, const std::string& name = "");
+    bool writePattern(const Pattern& pattern, const std::string& filename);
+
+    const std::string& getError() const { return error; }
+    uint64_t getBytesWritten() const { return bytesWritten; }
+
+private:
+    std::ofstream file;
+    std::vector<char> buffer;
+    size_t lineLength;
+    uint64_t bytesWritten;
+    std::string error;
+
+    bool writeRows(const std::string& filename, const std::string& name, const std::string& description,
+                   const std::string& rule, unsigned int width, unsigned int height,
+                   const std::function<const uint64_t*(unsigned int)>& rowAt);
+    void writeText(const std::string& text);
+    void writeRun(uint64_t count, char tag);
+    void flush();
+};
+
+#endif // RLEWRITER_HPP
@@ -0,0 +1,114 @@
+#ifndef STATICPATTERN_HPP
+#define STATICPATTERN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Compile-time RLE decoding for patterns built into the binary. The body of
+// an RLE file ("bo$2bo$3o!") is turned into packed rows with Grid's bit
+// layout by the compiler, so built-ins cost nothing at startup:
+//
+//     constexpr char GLIDER[] = "bo$2bo$3o!";
+//     constexpr auto glider = staticpattern::decode<staticpattern::rleWidth(GLIDER),
+//                                                   staticpattern::rleHeight(GLIDER)>(GLIDER);
+//
+// Only the cell body is accepted (b or . dead, o or A live, $ row end, !
+// end); a malformed string fails to compile. repeat() lays copies of a
+// bitmap side by side for larger workloads.
+namespace staticpattern {
+
+template <unsigned int W, unsigned int H>
+struct Bitmap {
+    static constexpr unsigned int WIDTH = W;
+    static constexpr unsigned int HEIGHT = H;
+    static constexpr unsigned int WORDS_PER_ROW = (W + 63) / 64;
+
+    uint64_t rows[WORDS_PER_ROW * H > 0 ? WORDS_PER_ROW * H : 1] = {};
+};
+
+// Calls visit(x, y, count, alive) for each run, and returns the width (x
+// past the longest row) and height through the reference arguments
+template <typename Visitor>
+constexpr void scanRle(const char* rle, Visitor visit, unsigned int& width, unsigned int& height) {
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int count = 0;
+    width = 0;
+    for (const char* c = rle; *c != '!'; ++c) {
+        if (*c >= '0' && *c <= '9') {
+            count = count * 10 + static_cast<unsigned int>(*c - '0');
+            continue;
+        }
+
+        unsigned int run = count ? count : 1;
+        count = 0;
+        if (*c == 'b' || *c == '.' || *c == 'o' || *c == 'A') {
+            visit(x, y, run, *c == 'o' || *c == 'A');
+            x += run;
+            width = x > width ? x : width;
+        } else if (*c == '$') {
+            y += run;
+            x = 0;
+        } else if (*c == '\0') {
+            throw std::invalid_argument("RLE body is missing its terminating '!'");
+        } else if (*c != '\n' && *c != ' ') {
+            throw std::invalid_argument("Unexpected character in RLE body");
+        }
+    }
+    height = width ? y + 1 : 0;
+}
+
+constexpr unsigned int rleWidth(const char* rle) {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    scanRle(rle, [](unsigned int, unsigned int, unsigned int, bool) {}, width, height);
+    return width;
+}
+
+constexpr unsigned int rleHeight(const char* rle) {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    scanRle(rle, [](unsigned int, unsigned int, unsigned int, bool) {}, width, height);
+    return height;
+}
+
+template <unsigned int W, unsigned int H>
+constexpr Bitmap<W, H> decode(const char* rle) {
+    Bitmap<W, H> bitmap;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    scanRle(rle, [&bitmap](unsigned int x, unsigned int y, unsigned int count, bool alive) {
+        if (!alive) return;
+        for (unsigned int i = x; i < x + count; ++i) {
+            bitmap.rows[y * Bitmap<W, H>::WORDS_PER_ROW + i / 64] |= 1ULL << (i % 64);
+        }
+    }, width, height);
+    if (width != W || height != H) {
+        throw std::invalid_argument("RLE body does not match the bitmap size");
+    }
+    return bitmap;
+}
+
+// COUNT copies of a bitmap side by side, SPACING columns apart (at least
+// its width), e.g. a row of guns
+template <unsigned int COUNT, unsigned int SPACING, unsigned int W, unsigned int H>
+constexpr Bitmap<W + (COUNT - 1) * SPACING, H> repeat(const Bitmap<W, H>& bitmap) {
+    static_assert(COUNT > 0 && SPACING >= W, "Copies must not overlap");
+    using Result = Bitmap<W + (COUNT - 1) * SPACING, H>;
+    Result result;
+    for (unsigned int y = 0; y < H; ++y) {
+        for (unsigned int x = 0; x < W; ++x) {
+            if (!((bitmap.rows[y * Bitmap<W, H>::WORDS_PER_ROW + x / 64] >> (x % 64)) & 1ULL)) continue;
+            for (unsigned int copy = 0; copy < COUNT; ++copy) {
+                unsigned int column = x + copy * SPACING;
+                result.rows[y * Result::WORDS_PER_ROW + column / 64] |= 1ULL << (column % 64);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace staticpattern
+
+#endif // STATICPATTERN_HPP
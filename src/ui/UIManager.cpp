@@ -21,6 +21,7 @@ void UIManager::initializeButtons() {
     createSpeedDownButton(sf::Vector2f(startPos.x + 2 * (BUTTON_WIDTH + BUTTON_SPACING), startPos.y));
     createRandomButton(sf::Vector2f(startPos.x + 3 * (BUTTON_WIDTH + BUTTON_SPACING), startPos.y));
     createClearButton(sf::Vector2f(startPos.x + 4 * (BUTTON_WIDTH + BUTTON_SPACING), startPos.y));
+    createRewindButton(sf::Vector2f(startPos.x + 5 * (BUTTON_WIDTH + BUTTON_SPACING), startPos.y));
 }
 
 void UIManager::update() {
@@ -105,10 +106,16 @@ void UIManager::createClearButton(sf::Vector2f position) {
     buttons.push_back(std::move(button));
 }
 
+void UIManager::createRewindButton(sf::Vector2f position) {
+    auto button = std::make_unique<Button>("Rewind", position);
+    button->setClickCallback([this]() { onRewindButtonClick(); });
+    buttons.push_back(std::move(button));
+}
+
 sf::Vector2f UIManager::calculateButtonStartPosition() const {
     sf::Vector2u windowSize = gameEngine.getWindow().getSize();
 
-    float totalButtonWidth = (5 * BUTTON_WIDTH) + (4 * BUTTON_SPACING);
+    float totalButtonWidth = (BUTTON_COUNT * BUTTON_WIDTH) + ((BUTTON_COUNT - 1) * BUTTON_SPACING);
     float startX = (windowSize.x - totalButtonWidth) / 2.0f;
     float buttonY = MARGIN / 2.0f;
 
@@ -146,9 +153,14 @@ void UIManager::onSpeedDownButtonClick() {
 }
 
 void UIManager::onRandomButtonClick() {
-    gameEngine.getPatternManager().applyRandomPattern(gameEngine.getGrid());
+    gameEngine.seedPattern("random");
 }
 
 void UIManager::onClearButtonClick() {
-    gameEngine.getPatternManager().clearGrid(gameEngine.getGrid());
+    gameEngine.clearGrid();
+}
+
+void UIManager::onRewindButtonClick() {
+    gameEngine.stepBackward();
+    updatePauseButton(gameEngine.isPaused());
 }
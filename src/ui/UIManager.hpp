@@ -38,6 +38,7 @@ public:
     static constexpr float BUTTON_HEIGHT = 40.0f;
     static constexpr float BUTTON_SPACING = 10.0f;
     static constexpr float MARGIN = 60.0f;
+    static constexpr int BUTTON_COUNT = 6;
 
 private:
     GameEngine& gameEngine;
@@ -49,6 +50,7 @@ private:
     void createSpeedDownButton(sf::Vector2f position);
     void createRandomButton(sf::Vector2f position);
     void createClearButton(sf::Vector2f position);
+    void createRewindButton(sf::Vector2f position);
     
     // Layout calculation
     sf::Vector2f calculateButtonStartPosition() const;
@@ -60,6 +62,7 @@ private:
     void onSpeedDownButtonClick();
     void onRandomButtonClick();
     void onClearButtonClick();
+    void onRewindButtonClick();
 };
 
 #endif // UIMANAGER_HPP
\ No newline at end of file